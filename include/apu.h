@@ -0,0 +1,134 @@
+#ifndef APU_H
+#define APU_H
+
+#include "common.h"
+#include "blip.h"
+
+// Reloj del sistema (ticks por segundo)
+#define APU_CLOCK_RATE 4194304
+
+#define APU_DEFAULT_SAMPLE_RATE 48000
+#define APU_MAX_SAMPLE_RATE     96000
+
+// Frame sequencer: 512 Hz (flanco del bit 12 de DIV)
+#define APU_SEQ_TICKS 8192
+
+// Registros de sonido (índices en bus.io)
+#define REG_NR10 0x10
+#define REG_NR11 0x11
+#define REG_NR12 0x12
+#define REG_NR13 0x13
+#define REG_NR14 0x14
+#define REG_NR21 0x16
+#define REG_NR22 0x17
+#define REG_NR23 0x18
+#define REG_NR24 0x19
+#define REG_NR30 0x1A
+#define REG_NR31 0x1B
+#define REG_NR32 0x1C
+#define REG_NR33 0x1D
+#define REG_NR34 0x1E
+#define REG_NR41 0x20
+#define REG_NR42 0x21
+#define REG_NR43 0x22
+#define REG_NR44 0x23
+#define REG_NR50 0x24
+#define REG_NR51 0x25
+#define REG_NR52 0x26
+#define REG_WAVE 0x30 // Wave RAM: $FF30-$FF3F
+
+#define APU_CHANNELS 4
+
+typedef enum {
+    APU_CH_SQUARE1 = 0, // Cuadrada con sweep
+    APU_CH_SQUARE2,     // Cuadrada
+    APU_CH_WAVE,        // Onda de la Wave RAM
+    APU_CH_NOISE,       // Ruido (LFSR)
+} ApuChannelId;
+
+typedef struct {
+    bool enabled;       // Canal activo (bits 0-3 de NR52)
+    bool dac;           // DAC encendido
+    u16 length;         // Contador de duración (al llegar a 0 se apaga)
+    bool length_enable; // Bit 6 de NRx4
+
+    // Generador
+    u64 next_edge;      // Próximo paso de la forma de onda (ticks)
+    u8 step;            // Posición: duty (0-7) u onda (0-31)
+    u16 lfsr;           // Solo ruido
+
+    // Envolvente (fijada en el trigger)
+    u8 volume;
+    u8 env_period;
+    bool env_up;
+    u8 env_timer;
+
+    i32 amp;            // Salida (0-15) ya enviada al mezclador
+} ApuChannel;
+
+// APU
+// No avanza por ciclo: apu_sync sintetiza de golpe desde la última vez
+// hasta gb->ticks, y solo se llama al escribir un registro de sonido, al
+// leer NR52 o al sacar muestras. Cada canal entrega sus cambios de salida
+// a dos Blip (izquierda y derecha).
+typedef struct {
+    ApuChannel ch[APU_CHANNELS];
+
+    // Sweep del canal 1
+    u16 sweep_shadow;
+    u8 sweep_timer;
+    bool sweep_enabled;
+
+    // Frame sequencer
+    u64 next_seq;       // Instante (ticks) del próximo paso
+    u8 seq_step;        // 0-7
+
+    u64 time;           // Sintetizado hasta aquí (ticks)
+    bool synth;         // Se generan muestras (false = solo estado de registros)
+    u32 sample_rate;
+    Blip left;
+    Blip right;
+} Apu;
+
+// Estado posterior a la boot ROM. sample_rate 0 = APU_DEFAULT_SAMPLE_RATE.
+void apu_init(GameBoy* gb, u32 sample_rate);
+
+// Modo sin audio (bots, tests): se mantiene todo lo que el juego puede ver
+// (NR52, contadores de duración, sweep, frame sequencer), pero no se generan
+// formas de onda ni se mezcla. Cambiar de modo no altera nada visible desde
+// el juego; al volver a activarlo el audio empieza en silencio.
+void apu_set_synth(GameBoy* gb, bool enabled);
+
+// Sintetiza hasta gb->ticks
+void apu_sync(GameBoy* gb);
+
+// Lectura y escritura de $FF10-$FF3F
+u8 apu_read(GameBoy* gb, u16 address);
+void apu_write(GameBoy* gb, u16 address, u8 value);
+
+// DIV se ha puesto a 0: el frame sequencer vuelve a contar desde ahí
+void apu_reset_div(GameBoy* gb);
+
+// Multiplica la frecuencia de muestreo efectiva por ratio (control de ritmo
+// con el dispositivo de audio, ver audio_ring.h). Afecta a lo que se
+// sintetice a partir de ahora.
+void apu_set_rate_adjust(GameBoy* gb, double ratio);
+
+// Vacía los buffers de salida y vuelve a partir del estado actual de los
+// canales (tras cargar un estado, o al cambiar de modo)
+void apu_reset_output(GameBoy* gb);
+
+// Tras volver a emular un tramo con synth desactivado a mano (rollback) y
+// sincronizado (apu_sync) antes de reactivarlo: los generadores retoman la
+// fase desde ahora y la salida continúa desde lo ya sintetizado, sin vaciar
+// los buffers
+void apu_resume_output(GameBoy* gb);
+
+// Muestras estéreo disponibles (sincroniza antes). 0 en modo sin audio.
+int apu_samples_available(GameBoy* gb);
+
+// Lee hasta frames muestras estéreo entrelazadas (L, R) en out.
+// Devuelve las leídas. Si nadie las lee, las más antiguas se descartan.
+int apu_read_samples(GameBoy* gb, i16* out, int frames);
+
+#endif
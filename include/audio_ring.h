@@ -0,0 +1,58 @@
+#ifndef AUDIO_RING_H
+#define AUDIO_RING_H
+
+#include "common.h"
+
+// Anillo de audio entre la emulación (productor) y el callback del
+// dispositivo de audio (consumidor), sin locks: cada lado solo escribe su
+// propio índice, y los índices se publican con operaciones atómicas.
+// Como nunca se bloquea, el ritmo se mantiene de otra forma: el productor
+// ajusta un poco la relación ticks/muestra de la APU según lo lleno que está
+// el anillo (control dinámico de frecuencia). Si el dispositivo consume algo
+// más rápido de lo previsto, el anillo baja y la APU genera algo más de
+// muestras por frame, y al revés.
+
+#define AUDIO_RING_FRAMES 8192 // Frames estéreo (potencia de 2)
+
+// Ajuste máximo de la frecuencia (±0.5%, inaudible)
+#define AUDIO_RING_MAX_ADJUST 0.005
+
+typedef struct {
+    i16 samples[AUDIO_RING_FRAMES * 2]; // L, R entrelazados
+
+    // Cada lado empieza en su propia línea de caché (los dos hilos no se
+    // pisan). El anillo queda alineado a 64 bytes.
+
+    // Lado del productor
+    u64 head __attribute__((aligned(64))); // Frames escritos (atómico)
+    u32 target;     // Llenado objetivo (frames)
+    u64 overruns;   // Frames descartados por anillo lleno
+
+    // Lado del consumidor
+    u64 tail __attribute__((aligned(64))); // Frames leídos (atómico)
+    u64 underruns;  // Frames que faltaban (se rellenan con el último)
+    i16 last[2];
+} AudioRing;
+
+// target: frames que se intenta mantener en el anillo (latencia)
+void audio_ring_init(AudioRing* ring, u32 target);
+
+// Productor: escribe hasta count frames sin bloquear. Devuelve los escritos.
+int audio_ring_write(AudioRing* ring, const i16* frames, int count);
+
+// Consumidor: lee exactamente count frames; si no hay bastantes, completa
+// repitiendo el último. Devuelve los que había de verdad.
+int audio_ring_read(AudioRing* ring, i16* out, int count);
+
+// Frames en el anillo (se puede llamar desde cualquiera de los dos lados)
+u32 audio_ring_fill(const AudioRing* ring);
+
+// Productor: factor por el que multiplicar la frecuencia de muestreo de la
+// APU según el llenado actual (1.0 = en el objetivo)
+double audio_ring_rate_adjust(const AudioRing* ring);
+
+// Productor: pasa al anillo las muestras de la APU y reajusta su frecuencia.
+// Pensado para llamarse tras cada frame emulado. Devuelve los frames pasados.
+int audio_ring_pump(AudioRing* ring, GameBoy* gb);
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "common.h"
+
+// Ejecución por lotes: gameboy-emu batch <trabajos> [--threads N] [--slice F]
+// Cada línea del fichero de trabajos es una instancia sin ventana:
+//   <rom> <frames> [entrada] [salida]
+// entrada: "-" (nada pulsado), "seed=N" (botones pseudoaleatorios a partir
+// de N) o una película (empieza en su estado inicial; al acabarse, nada
+// pulsado). salida: "-" o un fichero donde dejar el estado final.
+// Las líneas vacías y las que empiezan por # se ignoran. Las instancias se
+// reparten en un pool con robo de trabajo (pool.h), de F frames en F
+// frames. Al final se escribe una línea por trabajo, con el hash de su
+// memoria, y los frames por segundo del total.
+
+// Frames por tramo, por defecto
+#define BATCH_SLICE_FRAMES 60
+
+int batch_main(int argc, char** argv);
+
+#endif
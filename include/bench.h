@@ -0,0 +1,9 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "common.h"
+
+// Microbenchmarks: gameboy-emu bench [nombre...]
+int bench_main(int argc, char** argv);
+
+#endif
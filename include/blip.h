@@ -0,0 +1,49 @@
+#ifndef BLIP_H
+#define BLIP_H
+
+#include "common.h"
+
+// Buffer de síntesis por escalones limitados en banda
+// Los canales no generan muestras: solo avisan de cuándo (en ticks) y cuánto
+// cambia su salida. Cada cambio se suma al buffer como un escalón ya filtrado
+// (un kernel sinc con ventana de BLIP_TAPS muestras, elegido según la fase
+// del instante dentro de la muestra). La salida es la integral de esos
+// deltas, directamente a la frecuencia del host: no hay señal a 1 MHz ni
+// remuestreo posterior.
+
+#define BLIP_FRAC_BITS   20   // Bits de fracción de muestra en las posiciones
+#define BLIP_PHASE_BITS  5
+#define BLIP_PHASES      (1 << BLIP_PHASE_BITS)
+#define BLIP_TAPS        16
+#define BLIP_KERNEL_BITS 15   // Cada fila del kernel suma 1 << BLIP_KERNEL_BITS
+#define BLIP_BASS_SHIFT  9    // Filtro paso alto (quita la continua)
+#define BLIP_CAPACITY    8192 // Muestras
+
+typedef struct {
+    u64 factor;     // Muestras por tick, en coma fija (BLIP_FRAC_BITS)
+    u64 offset;     // Posición del inicio del frame actual (coma fija)
+    int avail;      // Muestras terminadas, listas para leer
+    i32 integrator; // Suma de los deltas leídos hasta ahora
+    i32 buf[BLIP_CAPACITY + BLIP_TAPS];
+} Blip;
+
+void blip_init(Blip* blip, u32 clock_rate, u32 sample_rate);
+
+// Cambia la relación ticks/muestra (no afecta a lo ya sintetizado)
+void blip_set_factor(Blip* blip, u64 factor);
+
+// Factor en coma fija para clock_rate ticks/s y sample_rate muestras/s
+u64 blip_factor(u32 clock_rate, u32 sample_rate);
+
+// Suma un cambio de delta en la salida en el instante time (ticks desde el
+// inicio del frame actual)
+void blip_add_delta(Blip* blip, u32 time, int delta);
+
+// Cierra el frame actual tras time ticks: sus muestras pasan a estar listas
+void blip_end_frame(Blip* blip, u32 time);
+
+// Lee (y quita) hasta count muestras, escribiendo cada stride elementos de
+// out. Con out == NULL las descarta. Devuelve las muestras leídas.
+int blip_read(Blip* blip, i16* out, int count, int stride);
+
+#endif
@@ -9,6 +9,24 @@
 #define HRAM_SIZE 127
 #define OAM_SIZE  160
 
+// Modos de acceso especiales del bus (bits de Bus.access_mode)
+// Si access_mode es 0 el bus funciona con el mapeo normal; así la ruta común
+// de bus_read/bus_write solo paga una comprobación para todos los casos raros.
+#define BUS_MODE_TEST 0x01 // Tests JSON: memoria plana de 64KB
+#define BUS_MODE_DMA  0x02 // OAM DMA en curso: la CPU solo ve I/O y la HRAM
+
+// Páginas sucias: un bit por cada página de 256 bytes del mapa de memoria
+// que se ha escrito desde la última instantánea. Permite copiar o hashear
+// solo lo que ha cambiado (gb_update_state, rewind, gb_memory_hash).
+// El espejo de la WRAM ($E000-$FDFF) marca su propia página: para consultar
+// hay que usar bus_page_dirty, que mira las dos.
+// Los registros de IO no se siguen (la PPU y el timer los cambian sin pasar
+// por el bus): quien los use los tiene que copiar siempre.
+#define BUS_PAGE_SHIFT  8
+#define BUS_PAGE_SIZE   (1 << BUS_PAGE_SHIFT)
+#define BUS_PAGES       (65536 >> BUS_PAGE_SHIFT)
+#define BUS_DIRTY_WORDS (BUS_PAGES / 64)
+
 typedef struct {
     // Memoria interna de la consola
     u8 wram[WRAM_SIZE]; // Working RAM
@@ -19,11 +37,14 @@ typedef struct {
     // Registros de Hardware (IO)
     u8 io[0x80]; // $FF00 - $FF7F
 
+    // Modos especiales (BUS_MODE_*)
+    u8 access_mode;
+
+    // Páginas escritas desde la última instantánea (bitmap)
+    u64 dirty[BUS_DIRTY_WORDS];
+
     // --- MODO TEST ---
-    bool test_mode;         // Si es true, ignoramos el mapeo anterior
     u8 flat_memory[65536];  // 64KB de RAM plana para los tests JSON
-
-    // ... Punteros al Cartucho (Lo veremos luego)
 } Bus;
 
 // Prototipos de funcions
@@ -35,4 +56,24 @@ void bus_write(GameBoy* gb, u16 address, u8 value);
 u16 bus_read16(GameBoy* gb, u16 address);
 void bus_write16(GameBoy* gb, u16 addr, u16 value);
 
+// Marca como escrita la página de address (una sola OR)
+static inline void bus_mark_dirty(Bus* bus, u16 address) {
+    bus->dirty[address >> 14] |= 1ULL << ((address >> BUS_PAGE_SHIFT) & 63);
+}
+
+// ¿Se ha escrito la página de address? En la WRAM cuenta también su espejo.
+static inline bool bus_page_dirty(const u64* pages, u16 address) {
+    u16 page = address >> BUS_PAGE_SHIFT;
+    bool dirty = (pages[page >> 6] >> (page & 63)) & 1;
+    if (address >= 0xC000 && address < 0xDE00) {
+        page += 0x20;
+        dirty |= (pages[page >> 6] >> (page & 63)) & 1;
+    }
+    return dirty;
+}
+
+static inline void bus_clear_dirty(Bus* bus) {
+    for (int i = 0; i < BUS_DIRTY_WORDS; i++) bus->dirty[i] = 0;
+}
+
 #endif
\ No newline at end of file
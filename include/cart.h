@@ -0,0 +1,86 @@
+#ifndef CART_H
+#define CART_H
+
+#include <stddef.h>
+#include "common.h"
+
+// Tamaño de un banco de ROM ($4000) y de RAM externa ($2000)
+#define ROM_BANK_SIZE 0x4000
+#define RAM_BANK_SIZE 0x2000
+
+// Controladores de memoria (byte $0147 de la cabecera)
+typedef enum {
+    MBC_NONE = 0,
+    MBC_1,
+    MBC_3,
+    MBC_5,
+} MbcType;
+
+// Máximo de bancos de RAM externa (128KB)
+#define CART_MAX_RAM_BANKS 16
+
+// Imagen de una ROM, compartida (solo lectura) por todas las instancias que
+// la usan. Se libera al soltar la última referencia.
+// Las imágenes cargadas están en una caché del proceso por hash del
+// contenido: cargar otra vez la misma ROM (aunque sea desde otro fichero)
+// devuelve la misma imagen, así que cien instancias del mismo juego tienen
+// una sola copia. El fichero se mapea en memoria de solo lectura, sin copiar
+// nada; no hay que reescribirlo mientras esté cargado.
+typedef struct RomImage {
+    u32 refs;         // Atómico; llega a 0 solo con el lock de la caché
+    size_t size;
+    const u8* data;
+    u64 hash;         // Del contenido
+    bool mapped;      // data es un mmap (si no, malloc)
+    struct RomImage* next; // Siguiente en la caché
+} RomImage;
+
+// Banco de RAM externa. Tras gb_fork los bancos se comparten entre las dos
+// instancias y se copian al escribir en ellos (copy-on-write).
+typedef struct {
+    u32 refs;         // Atómico
+    u8 data[RAM_BANK_SIZE];
+} CartRamBank;
+
+typedef struct {
+    RomImage* image;  // Referencia a la imagen (NULL sin cartucho)
+    const u8* rom;    // image->data
+    size_t rom_size;
+    CartRamBank* ram[CART_MAX_RAM_BANKS]; // RAM externa (vacío si no tiene)
+    u8 ram_banks;
+    size_t ram_size;
+
+    u8 mbc;           // MbcType
+    bool ram_enable;  // Registro $0000-$1FFF
+    u16 rom_bank;     // Banco mapeado en $4000-$7FFF
+    u8 ram_bank;      // Banco mapeado en $A000-$BFFF
+    u8 mode;          // MBC1: modo de banking ($6000-$7FFF)
+} Cart;
+
+// Carga la ROM de path (de la caché si ya está). Devuelve false (y deja el
+// cartucho vacío) si no se puede leer o el tipo de MBC no está soportado.
+// Se puede llamar desde varios hilos a la vez.
+bool cart_load(Cart* cart, const char* path);
+void cart_free(Cart* cart);
+
+// Imágenes distintas en la caché ahora mismo
+int cart_cached_images(void);
+
+// Copia el cartucho de parent en child (que no debe tener ninguno): la ROM
+// y los bancos de RAM se comparten, solo se copian los registros del MBC
+void cart_fork(Cart* child, const Cart* parent);
+
+// Banco n de la RAM externa para leer, o para escribir (si está compartido,
+// se copia antes)
+const u8* cart_ram_bank(const Cart* cart, int n);
+u8* cart_ram_bank_writable(Cart* cart, int n);
+
+// $0000-$7FFF: lectura de ROM / escritura en registros del MBC
+u8 cart_read(const Cart* cart, u16 address);
+void cart_write(Cart* cart, u16 address, u8 value);
+
+// $A000-$BFFF: RAM externa
+u8 cart_read_ram(const Cart* cart, u16 address);
+void cart_write_ram(Cart* cart, u16 address, u8 value);
+
+#endif
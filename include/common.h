@@ -10,6 +10,8 @@ typedef uint8_t  u8;
 typedef uint16_t u16;
 typedef uint32_t u32;
 typedef uint64_t u64;
+typedef int16_t  i16;
+typedef int32_t  i32;
 
 // Declaramos que "existe" una estructura llamada GameBoy.
 // Esto permite usar (GameBoy*) en los prototipos de función de bus.h y cpu.h
@@ -0,0 +1,29 @@
+#ifndef DMA_H
+#define DMA_H
+
+#include "bus.h"
+
+// Duración de la transferencia OAM DMA: 160 bytes a 1 byte por M-Cycle,
+// más 1 M-Cycle de arranque. Medido en ticks (T-Cycles).
+#define DMA_LENGTH          OAM_SIZE
+#define DMA_STARTUP_TICKS   4
+#define DMA_DURATION_TICKS  (DMA_STARTUP_TICKS + DMA_LENGTH * 4)
+
+typedef struct {
+    bool active;  // Hay una transferencia en curso
+    u16 source;   // Dirección de origen (XX00)
+    u64 start;    // Instante (ticks) en que se escribió en $FF46
+    u8 copied;    // Bytes ya volcados a la OAM (copia por tramos)
+} Dma;
+
+// Escritura en $FF46: arranca una transferencia desde value * 0x100
+void dma_start(GameBoy* gb, u8 value);
+
+// Copia a la OAM los bytes que ya deberían haberse transferido hasta
+// gb->ticks. Solo es necesario si alguien necesita ver la OAM a medias.
+void dma_sync(GameBoy* gb);
+
+// Manejador del evento EVENT_DMA (fin de la transferencia)
+void dma_event(GameBoy* gb);
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef FRAMEBUFFER_H
+#define FRAMEBUFFER_H
+
+#include "common.h"
+#include "ppu.h"
+
+// Framebuffer con triple buffer para pasar frames a otros hilos
+// La emulación dibuja siempre en "back" y, al terminar un frame (VBlank),
+// lo intercambia de forma atómica con "middle". El consumidor intercambia
+// "middle" con "front" cuando hay uno nuevo. Nadie espera a nadie: si el
+// consumidor es lento, los frames intermedios se pierden (y se cuentan).
+
+// Los frames se guardan como la DMG los ve: 4 tonos, 2 bits por píxel
+// (5760 bytes por frame). Pasarlos a RGBA o a grises es cosa de quien los
+// consume (fb_to_rgba, fb_to_gray), con kernels SIMD.
+
+#define FB_COUNT 3
+#define FB_FRESH 0x80 // Bit en middle: hay un frame publicado sin recoger
+
+#define FB_LINE_BYTES  (LCD_WIDTH / 4)
+#define FB_FRAME_BYTES (LCD_HEIGHT * FB_LINE_BYTES)
+#define FB_PIXELS      (LCD_WIDTH * LCD_HEIGHT)
+
+typedef struct {
+    // 2bpp empaquetado: el píxel x está en los bits 2*(x%4) del byte x/4
+    u8 pixels[LCD_HEIGHT][FB_LINE_BYTES];
+    u8 palette[4][4]; // Color RGBA de cada tono, fijado al publicar
+    u64 seq;    // Número de publicación (1, 2, 3...)
+    u64 frame;  // Frame emulado (ppu.frame_count)
+} Frame;
+
+typedef struct {
+    Frame frames[FB_COUNT];
+    u8 palette[4][4]; // Colores de los tonos 0-3 (gris por defecto)
+
+    // Lado de la emulación
+    u8 back;          // Frame en el que se está dibujando
+    u8 last;          // Último frame publicado (sigue siendo de solo lectura)
+    u64 published;    // Frames publicados (atómico, lo leen otros hilos)
+
+    // Compartido
+    u32 middle;       // Índice | FB_FRESH (atómico)
+
+    // Lado del consumidor
+    u8 front;         // Frame que tiene el consumidor
+    u64 consumed;     // seq del último frame recogido
+    u64 dropped;      // Frames publicados que el consumidor nunca vio
+} FrameBuffer;
+
+void fb_init(FrameBuffer* fb);
+
+// Cambia los colores con los que se publican los siguientes frames
+void fb_set_palette(FrameBuffer* fb, const u8 palette[4][4]);
+
+// Emulación: línea ly (empaquetada) del frame en el que se está dibujando
+static inline u8* fb_back_line(FrameBuffer* fb, u8 ly) {
+    return fb->frames[fb->back].pixels[ly];
+}
+
+// Escribe el tono de un píxel suelto en una línea empaquetada
+static inline void fb_line_set(u8* line, u8 x, u8 shade) {
+    u8 shift = (x & 3) * 2;
+    line[x >> 2] = (line[x >> 2] & ~(3 << shift)) | (shade << shift);
+}
+
+// Emulación: línea ly del último frame publicado (válida hasta el
+// siguiente fb_publish)
+static inline const u8* fb_last_line(const FrameBuffer* fb, u8 ly) {
+    return fb->frames[fb->last].pixels[ly];
+}
+
+// Emulación: publica el frame terminado y pasa a dibujar en otro
+void fb_publish(FrameBuffer* fb, u64 frame);
+
+// Consumidor: el último frame completo, sin copias. Es válido hasta la
+// siguiente llamada. Devuelve NULL si todavía no se ha publicado ninguno.
+const Frame* fb_acquire(FrameBuffer* fb);
+
+// Conversiones para los consumidores (FB_PIXELS píxeles de salida):
+// tonos 0-3, luminancia de la paleta del frame o RGBA (4 bytes por píxel)
+void fb_unpack(const Frame* frame, u8* out);
+void fb_to_gray(const Frame* frame, u8* out);
+void fb_to_rgba(const Frame* frame, u8* out);
+
+#endif
@@ -4,15 +4,69 @@
 #include "common.h"
 #include "bus.h"
 #include "cpu.h"
+#include "cart.h"
+#include "sched.h"
+#include "dma.h"
+#include "timer.h"
+#include "joypad.h"
+#include "serial.h"
+#include "apu.h"
+#include "ppu.h"
+#include "framebuffer.h"
+
+// Opciones de cada instancia (se fijan en gb_init)
+typedef struct {
+    PpuBackend ppu_backend; // FAST (por defecto) o FIFO (precisión por T-Cycle)
+    u32 sample_rate;        // Frecuencia de salida del audio (0 = 48000)
+    bool no_audio;          // APU sin síntesis (apu_set_synth)
+} GbConfig;
 
 // El contexto global de la emulación
 struct GameBoy {
     Bus bus;
     Cpu cpu;
+    Cart cart; // Vacío hasta cart_load (tras gb_init)
     bool paused;
     
-    // Contador global de ciclos de sistema
+    // Contador global de ciclos de sistema (T-Cycles)
     u64 ticks; 
+
+    // Eventos programados de los periféricos
+    Scheduler sched;
+
+    // Periféricos
+    Dma dma;
+    Timer timer;
+    Joypad joypad;
+    Serial serial;
+    Ppu ppu;
+    Apu apu;
+
+    // Frames terminados (triple buffer, se pueden leer desde otros hilos)
+    FrameBuffer fb;
 };
 
-#endif
\ No newline at end of file
+// Deja la consola en el estado posterior a la boot ROM.
+// config puede ser NULL (opciones por defecto).
+void gb_init(GameBoy* gb, const GbConfig* config);
+
+// Ejecuta una instrucción, avanza ticks y atiende los eventos vencidos.
+// Devuelve los T-Cycles consumidos.
+int gb_step(GameBoy* gb);
+
+// Copia barata de una instancia (búsqueda en árbol, RL...): la ROM y los
+// bancos de RAM externa se comparten (copy-on-write), el resto del estado
+// se copia. Las opciones (backend, política de dibujado, audio) se heredan.
+// Las cachés de la PPU no se copian: se rehacen si el hijo llega a dibujar.
+// El cable link no se hereda (serial_connect).
+// gb_fork reserva la instancia (se libera con gb_free); gb_fork_into
+// reutiliza child, que tiene que haber pasado por gb_init o por un fork.
+GameBoy* gb_fork(const GameBoy* parent);
+void gb_fork_into(GameBoy* child, const GameBoy* parent);
+void gb_free(GameBoy* gb);
+
+// Ejecuta hasta completar un frame (entrada en VBlank). Con el LCD apagado
+// se para tras FRAME_TICKS. Devuelve los ticks ejecutados.
+u64 gb_run_frame(GameBoy* gb);
+
+#endif
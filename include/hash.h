@@ -0,0 +1,18 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <stddef.h>
+#include "common.h"
+
+// Hash de 64 bits para comparar contenidos (memoria de una instancia, ROMs
+// de la caché). No es criptográfico.
+
+#define HASH_SEED 0xCBF29CE484222325ULL
+
+// Añade size bytes de data al hash h (HASH_SEED para empezar)
+u64 hash_bytes(const u8* data, size_t size, u64 h);
+
+// Añade un valor de 64 bits al hash h
+u64 hash_combine(u64 h, u64 v);
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HOST_CLOCK_H
+#define HOST_CLOCK_H
+
+#include "common.h"
+
+// Reloj monotónico del host en nanosegundos, para medir tiempos de
+// emulación (bench, batch, run-ahead, rollback)
+u64 now_ns(void);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef JOYPAD_H
+#define JOYPAD_H
+
+#include "common.h"
+
+// Joypad (registro P1, $FF00)
+// El juego elige con los bits 4-5 (a 0) qué grupo quiere leer y lo lee en
+// los bits 0-3, con 0 = pulsado. La interrupción salta cuando una de las
+// líneas 0-3 pasa de 1 a 0 (una tecla del grupo seleccionado se pulsa, o se
+// selecciona un grupo con una tecla ya pulsada).
+
+#define REG_P1_ADDR 0xFF00
+
+// Botones (bit a 1 = pulsado). La mitad baja son las direcciones y la alta
+// los botones de acción, en el orden de las líneas del registro.
+#define JOYPAD_RIGHT  0x01
+#define JOYPAD_LEFT   0x02
+#define JOYPAD_UP     0x04
+#define JOYPAD_DOWN   0x08
+#define JOYPAD_A      0x10
+#define JOYPAD_B      0x20
+#define JOYPAD_SELECT 0x40
+#define JOYPAD_START  0x80
+
+// Bits de P1 que seleccionan grupo (a 0 = seleccionado)
+#define P1_SELECT_DPAD    4
+#define P1_SELECT_BUTTONS 5
+
+typedef struct {
+    u8 buttons;  // JOYPAD_* pulsados
+    u8 select;   // Bits 4-5 escritos en P1
+} Joypad;
+
+// Estado posterior a la boot ROM (ningún grupo seleccionado)
+void joypad_init(GameBoy* gb);
+
+// Cambia los botones pulsados (desde fuera de la emulación)
+void joypad_set(GameBoy* gb, u8 buttons);
+
+// Lectura y escritura de P1
+u8 joypad_read(GameBoy* gb);
+void joypad_write(GameBoy* gb, u8 value);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef MOVIE_H
+#define MOVIE_H
+
+#include <stddef.h>
+#include "common.h"
+
+// Películas: la entrada del joypad de cada frame, para reproducir una
+// partida de forma determinista a partir de un estado inicial.
+// Cada keyframe_interval frames se guarda además un estado completo
+// (keyframe), así que ir al frame N es cargar el keyframe anterior y avanzar
+// como mucho keyframe_interval frames, sin dibujar, en lugar de reproducir
+// desde el principio.
+//
+// Fichero (little-endian):
+//   "GBMV" u32 versión, u32 keyframe_interval, u64 frames
+//   u8 entrada[frames]                 (botones JOYPAD_* de cada frame)
+//   u32 keyframes, y de cada uno: u64 frame, u32 tamaño, estado
+
+#define MOVIE_MAGIC   "GBMV"
+#define MOVIE_VERSION 1
+
+// Un keyframe cada 10 segundos por defecto
+#define MOVIE_DEFAULT_KEYFRAME_INTERVAL 600
+
+typedef struct {
+    u64 frame;    // Estado al empezar este frame
+    u8* state;
+    size_t size;
+} MovieKeyframe;
+
+typedef struct {
+    u32 keyframe_interval;
+
+    u8* inputs;       // Botones de cada frame
+    u64 frames;
+    u64 inputs_capacity;
+
+    MovieKeyframe* keyframes; // Ordenados por frame (el primero es el 0)
+    u32 keyframe_count;
+    u32 keyframes_capacity;
+
+    u64 position;     // Siguiente frame a grabar o reproducir
+} Movie;
+
+// keyframe_interval 0 = MOVIE_DEFAULT_KEYFRAME_INTERVAL
+void movie_init(Movie* movie, u32 keyframe_interval);
+void movie_free(Movie* movie);
+
+// Empieza a grabar desde el estado actual de gb (keyframe 0)
+bool movie_record_start(Movie* movie, const GameBoy* gb);
+
+// Graba y ejecuta un frame con los botones dados. Si se había vuelto atrás
+// con movie_seek, lo que hubiera a partir de aquí se descarta.
+bool movie_record_frame(Movie* movie, GameBoy* gb, u8 buttons);
+
+// Reproduce el siguiente frame. Devuelve false al final de la película.
+bool movie_play_frame(Movie* movie, GameBoy* gb);
+
+// Deja gb como estaba al empezar el frame (0 <= frame <= frames)
+bool movie_seek(Movie* movie, GameBoy* gb, u64 frame);
+
+bool movie_save(const Movie* movie, const char* path);
+bool movie_load(Movie* movie, const char* path);
+
+#endif
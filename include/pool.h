@@ -0,0 +1,41 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "common.h"
+
+// Pool de hilos con robo de trabajo
+// Cada hilo tiene su propia cola doble: saca y devuelve tareas por abajo
+// (la última que ha tocado, con su instancia aún en caché) y, cuando la suya
+// se vacía, roba por arriba de la de otro (las más antiguas, normalmente sin
+// empezar). Las tareas son trabajos largos troceados: cada llamada hace un
+// tramo y dice si queda más, y entonces vuelve a la cola de ese hilo, de
+// donde otro la puede robar si se queda sin nada.
+// Las colas llevan un mutex cada una: una tarea es un tramo de varios
+// milisegundos, así que el lock no se nota y nadie espera a nadie salvo al
+// robar.
+
+// Un tramo de la tarea. Devuelve true si queda más (vuelve a la cola).
+typedef bool (*PoolTaskFn)(void* arg, int worker);
+
+typedef struct WorkPool WorkPool;
+
+// threads 0 = uno por núcleo. capacity: tareas como máximo.
+WorkPool* pool_create(int threads, u32 capacity);
+void pool_destroy(WorkPool* pool);
+
+// Añade una tarea (antes de pool_run). Se reparten por turnos entre los
+// hilos. Devuelve false si no caben.
+bool pool_submit(WorkPool* pool, PoolTaskFn run, void* arg);
+
+// Arranca los hilos y espera a que terminen todas las tareas
+void pool_run(WorkPool* pool);
+
+int pool_threads(const WorkPool* pool);
+
+// Tareas robadas en pool_run (la medida del reparto)
+u64 pool_steals(const WorkPool* pool);
+
+// Núcleos disponibles
+int pool_cpu_count(void);
+
+#endif
@@ -0,0 +1,208 @@
+#ifndef PPU_H
+#define PPU_H
+
+#include "common.h"
+
+// Dimensiones de la pantalla
+#define LCD_WIDTH  160
+#define LCD_HEIGHT 144
+
+// Temporización (en ticks / T-Cycles)
+#define LINE_TICKS      456
+#define MODE2_TICKS     80   // Búsqueda en OAM
+#define MODE3_TICKS     172  // Dibujado
+#define LINES_PER_FRAME 154
+#define FRAME_TICKS     (LINE_TICKS * LINES_PER_FRAME)
+
+// Tiles en VRAM ($8000-$97FF): 384 tiles de 16 bytes
+#define TILE_COUNT      384
+#define TILE_DATA_END   0x9800
+#define OAM_ENTRIES     40
+#define SPRITES_PER_LINE 10
+#define ALL_SPRITES     ((1ULL << OAM_ENTRIES) - 1)
+
+// Registros de la PPU (índices en bus.io)
+#define REG_LCDC 0x40
+#define REG_STAT 0x41
+#define REG_SCY  0x42
+#define REG_SCX  0x43
+#define REG_LY   0x44
+#define REG_LYC  0x45
+#define REG_BGP  0x47
+#define REG_OBP0 0x48
+#define REG_OBP1 0x49
+#define REG_WY   0x4A
+#define REG_WX   0x4B
+
+// Bits de LCDC
+#define LCDC_BG_ENABLE   0
+#define LCDC_OBJ_ENABLE  1
+#define LCDC_OBJ_SIZE    2
+#define LCDC_BG_MAP      3
+#define LCDC_TILE_DATA   4
+#define LCDC_WIN_ENABLE  5
+#define LCDC_WIN_MAP     6
+#define LCDC_LCD_ENABLE  7
+
+// Atributos de sprite (byte 3 de cada entrada de OAM)
+#define OBJ_PALETTE      4
+#define OBJ_FLIP_X       5
+#define OBJ_FLIP_Y       6
+#define OBJ_BEHIND_BG    7
+
+// Modos de la PPU (bits 0-1 de STAT)
+typedef enum {
+    PPU_MODE_HBLANK = 0,
+    PPU_MODE_VBLANK = 1,
+    PPU_MODE_OAM    = 2,
+    PPU_MODE_DRAW   = 3,
+} PpuMode;
+
+// Backends de dibujado (se eligen por instancia en ppu_init)
+typedef enum {
+    PPU_BACKEND_FAST = 0, // Línea entera de una vez al final del modo 3
+    PPU_BACKEND_FIFO,     // Pixel FIFO, un paso por T-Cycle (modo 3 variable)
+} PpuBackend;
+
+// Política de dibujado por frame. Con cualquiera de ellas la PPU sigue
+// avanzando modos, LY/STAT e interrupciones igual; solo se ahorra producir
+// los píxeles de los frames que no se dibujan.
+typedef enum {
+    PPU_RENDER_ALL = 0,   // Todos los frames
+    PPU_RENDER_EVERY_N,   // Uno de cada N
+    PPU_RENDER_ON_DEMAND, // Solo el siguiente frame tras ppu_request_frame()
+    PPU_RENDER_NEVER,     // Ninguno
+} PpuRenderPolicy;
+
+// Estado del pixel FIFO durante el modo 3 de una línea
+typedef struct {
+    u64 tick;         // Instante (ticks) hasta el que se ha simulado
+    u64 end_tick;     // Instante en que se dibujó el último píxel
+    bool done;        // La línea ya tiene sus 160 píxeles
+    u8 startup;       // Dots de la primera búsqueda (se descarta)
+    u8 stall;         // Dots restantes de una búsqueda de sprite
+    u8 lx;            // Siguiente píxel de la línea (0-160)
+    u8 discard;       // Píxeles a descartar (SCX & 7, o WX < 7)
+
+    // Fetcher del fondo/ventana
+    u8 fetch_step;    // 0-5 leyendo, 6 esperando hueco en el FIFO
+    u8 fetch_x;       // Columna de tile del mapa
+    u8 tile_no;
+    u8 data[2];       // Plano bajo y alto de la fila del tile
+    bool window;      // El fetcher está leyendo la ventana
+
+    // FIFO del fondo (se rellena solo cuando está vacío)
+    u8 bg[8];
+    u8 bg_head;
+    u8 bg_count;
+
+    // FIFO de sprites, alineado con los próximos 8 píxeles de salida:
+    // bits 0-1 color, bit 2 paleta, bit 3 detrás del fondo
+    u8 obj[8];
+
+    // Sprites de la línea (orden de OAM) y los ya buscados
+    u8 sprites[SPRITES_PER_LINE];
+    u8 sprite_count;
+    u16 sprites_done;
+} PpuFifo;
+
+typedef struct {
+    // Caché de tiles: los 384 tiles decodificados de 2bpp planar a un
+    // índice de color (0-3) por byte, listos para copiar fila a fila.
+    u8 tiles[TILE_COUNT][8][8];
+    u64 tile_dirty[TILE_COUNT / 64]; // Tiles a redecodificar (bitmap)
+    u32 tile_version[TILE_COUNT];    // Se incrementa cada vez que se redecodifica
+
+    // Índice de sprites por línea: bit i de line_sprites[ly] = la entrada i
+    // de la OAM toca la línea ly. Solo se rehace para las entradas cuya Y ha
+    // cambiado, o entero si cambia el tamaño de sprite (LCDC.2).
+    u64 line_sprites[LCD_HEIGHT];
+    u8 sprite_y[OAM_ENTRIES];  // Y con la que se indexó cada entrada
+    u64 sprite_dirty;          // Entradas a reindexar (bitmap)
+    u8 sprite_height;          // Altura del índice actual (0 = sin construir)
+
+    // Caché de líneas (solo backend FAST): hash de todo lo que determina
+    // cada línea en el último frame dibujado. Si coincide, la línea se copia
+    // del último frame publicado en lugar de volver a dibujarla. Los hashes
+    // del frame en curso solo pasan a line_hash cuando se publica: un frame
+    // que se queda a medias (LCD apagado) no llega a fb_last_line.
+    bool line_cache;             // Activada (por defecto con FAST)
+    u64 line_hash[LCD_HEIGHT];   // 0 = no válido
+    u64 line_hash_next[LCD_HEIGHT];
+    u64 line_cache_hits;
+    u64 line_cache_misses;
+
+    // Frame skip
+    u8 render_policy;     // PpuRenderPolicy
+    u32 render_interval;  // N de PPU_RENDER_EVERY_N
+    bool render_request;  // Petición pendiente (PPU_RENDER_ON_DEMAND)
+    bool render_frame;    // El frame en curso produce píxeles
+
+    u8 backend;       // PpuBackend elegido en ppu_init
+    PpuFifo fifo;     // Estado del backend PPU_BACKEND_FIFO
+
+    u8 mode;          // PpuMode actual
+    u8 window_line;   // Contador interno de líneas de la ventana
+    bool stat_line;   // Estado de la línea de interrupción STAT (flanco)
+    u64 line_start;   // Instante (ticks) en que empezó la línea actual
+    u64 frame_count;  // Frames completados (entradas en VBlank)
+} Ppu;
+
+void ppu_init(GameBoy* gb, PpuBackend backend);
+
+// Pone al día el dibujado antes de que cambie un registro de la PPU.
+// Solo hace algo con el backend FIFO en modo 3.
+void ppu_sync(GameBoy* gb);
+
+// Frame skip: la política se aplica a partir del siguiente frame
+void ppu_set_render_policy(GameBoy* gb, PpuRenderPolicy policy, u32 interval);
+void ppu_request_frame(GameBoy* gb);
+
+// Activa o desactiva la caché de líneas (solo tiene efecto con FAST)
+void ppu_set_line_cache(GameBoy* gb, bool enabled);
+
+// Descarta las cachés derivadas de VRAM/OAM (tiles, índice de sprites y
+// hashes de línea), p. ej. tras sustituir la memoria al cargar un estado
+void ppu_invalidate_caches(GameBoy* gb);
+
+// Escrituras en registros con efectos secundarios
+void ppu_write_lcdc(GameBoy* gb, u8 value);
+void ppu_write_stat(GameBoy* gb, u8 value);
+void ppu_write_lyc(GameBoy* gb, u8 value);
+
+// Manejador del evento EVENT_PPU (cambio de modo)
+void ppu_event(GameBoy* gb);
+
+// --- Uso interno de los backends ---
+
+// Índice en la caché del tile n del mapa, según el modo de direccionamiento
+// de LCDC.4: $8000 sin signo, o $9000 con signo ($8800-$97FF).
+static inline int ppu_tile_index(u8 lcdc, u8 n) {
+    if (BIT(lcdc, LCDC_TILE_DATA)) return n;
+    return (n < 128) ? 256 + n : n;
+}
+
+// Sprites que tocan la línea ly, en orden de OAM (máximo 10)
+int ppu_select_sprites(GameBoy* gb, u8 ly, u8* selected);
+
+// Backend FIFO: preparar el modo 3 y avanzar hasta gb->ticks.
+// ppu_fifo_run devuelve true cuando la línea está completa.
+void ppu_fifo_start(GameBoy* gb);
+bool ppu_fifo_run(GameBoy* gb);
+
+// Marca como sucio el tile que contiene offset (relativo a $8000).
+// Se llama desde bus_write, solo para $8000-$97FF.
+static inline void ppu_invalidate_tile(Ppu* ppu, u16 offset) {
+    u16 tile = offset >> 4;
+    ppu->tile_dirty[tile >> 6] |= 1ULL << (tile & 63);
+}
+
+// Marca para reindexar la entrada de la OAM que contiene offset (relativo a
+// $FE00). Solo importa la Y: X, tile y atributos no cambian qué líneas toca.
+static inline void ppu_invalidate_sprite(Ppu* ppu, u8 offset) {
+    if ((offset & 3) == 0) {
+        ppu->sprite_dirty |= 1ULL << (offset >> 2);
+    }
+}
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <stddef.h>
+#include "common.h"
+#include "bus.h"
+
+// Rebobinado
+// Se guarda un estado por frame (rewind_push), pero solo el último completo.
+// Del resto se guarda la diferencia con el siguiente: el XOR de los dos
+// estados, casi todo ceros, comprimido con un RLE de ceros muy simple:
+//   varint ceros, varint literales, literales (bytes del XOR)
+// Volver un frame atrás es aplicar (XOR) la diferencia más reciente al
+// estado completo y cargarlo. Las diferencias viven en un anillo de bytes de
+// tamaño fijo; cuando no caben se descartan las más antiguas.
+// Los estados no se guardan enteros cada vez: el auxiliar se pone al día con
+// gb_update_state copiando solo las páginas sucias (bus.dirty), y el bitmap
+// se limpia en cada rewind_push.
+
+typedef struct {
+    size_t offset;  // Posición en data
+    size_t size;    // Bytes comprimidos
+} RewindEntry;
+
+typedef struct {
+    size_t state_size;
+    u8* head;           // Último estado guardado (completo)
+    u8* current;        // Auxiliar: el estado anterior a head
+    u8* scratch;        // Auxiliar para comprimir (peor caso)
+    bool has_head;
+    u64 last_dirty[BUS_DIRTY_WORDS]; // Páginas que difieren entre current y head
+
+    // Diferencias: entries[first .. first + count) en orden, de la más antigua
+    // a la más reciente
+    RewindEntry* entries;
+    u32 capacity;       // Frames como máximo
+    u32 first;
+    u32 count;
+
+    // Anillo de bytes con las diferencias comprimidas
+    u8* data;
+    size_t data_size;
+    size_t write;       // Donde irá la siguiente
+    size_t used;        // Bytes ocupados por las diferencias vivas
+} Rewind;
+
+// frames: cuántos frames hacia atrás como máximo. bytes: memoria para las
+// diferencias (0 = una estimación a partir del tamaño del estado).
+bool rewind_init(Rewind* rw, const GameBoy* gb, u32 frames, size_t bytes);
+void rewind_free(Rewind* rw);
+
+// Guarda el estado actual (una vez por frame). Limpia bus.dirty.
+void rewind_push(Rewind* rw, GameBoy* gb);
+
+// Restaura el estado anterior al último guardado. Devuelve false si no queda
+// ninguno. El estado restaurado pasa a ser el último (se puede seguir
+// retrocediendo, o avanzar y volver a guardar desde ahí).
+bool rewind_step_back(Rewind* rw, GameBoy* gb);
+
+// Frames a los que se puede volver
+static inline u32 rewind_available(const Rewind* rw) {
+    return rw->count;
+}
+
+#endif
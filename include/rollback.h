@@ -0,0 +1,123 @@
+#ifndef ROLLBACK_H
+#define ROLLBACK_H
+
+#include <stddef.h>
+#include "common.h"
+
+// Rollback para partidas de dos jugadores
+// Cada extremo emula las dos consolas (gb[0] y gb[1]) con la entrada de las
+// dos: la suya la tiene al momento y la del otro le llega por un transporte.
+// Si la remota de un frame no ha llegado se predice (la última recibida) y
+// se sigue. Al llegar la de verdad, si la predicción falló, se vuelve al
+// estado guardado de ese frame y se emula otra vez hasta el actual, todo
+// dentro de la misma llamada. Hace falta un estado por frame: se guardan los
+// de los últimos max_frames (N). Si el otro extremo se retrasa más de N
+// frames no se puede predecir más: rollback_frame no avanza (espera).
+// Los frames que se vuelven a emular no generan audio (el que sonó con la
+// predicción se queda) y solo se dibuja el último.
+
+// Como mucho 8 frames hacia atrás (133 ms). Volver atrás N frames es emular
+// 2N frames dentro de un frame del host: en bench rollback el peor caso con
+// N = 8 se queda en menos de la mitad de un frame, y con 16 llegaba a
+// pasarse. En un host más lento también N = 8 se puede pasar (el bench lo
+// marca).
+#define ROLLBACK_MAX_FRAMES 8
+
+// Entradas guardadas: las N pasadas y hasta N que lleguen adelantadas
+#define ROLLBACK_INPUTS (2 * (ROLLBACK_MAX_FRAMES + 1))
+
+typedef struct {
+    u64 frame;
+    u8 buttons;    // JOYPAD_*
+} RollbackInput;
+
+// Transporte: tiene que ser fiable (no se pierde nada), el orden da igual
+typedef struct {
+    void* ctx;
+    bool (*send)(void* ctx, const RollbackInput* input);
+    bool (*poll)(void* ctx, RollbackInput* input); // false = no hay nada
+} RollbackTransport;
+
+typedef struct {
+    GameBoy* gb[2];
+    u8 local;               // Jugador de este extremo (0 o 1)
+    RollbackTransport transport;
+    u32 max_frames;         // N
+
+    // Estado de las dos consolas al empezar cada uno de los últimos N + 1
+    // frames (el del frame f en la ranura f % (N + 1))
+    u8* states;
+    size_t state_size[2];
+
+    u64 frame;              // Siguiente frame a emular
+    u64 confirmed;          // La entrada remota de [0, confirmed) ha llegado
+    u64 rollback_from;      // Primer frame mal predicho (UINT64_MAX = ninguno)
+
+    // Entrada de cada jugador en cada frame (la remota, predicha hasta que
+    // llega), en la posición frame % ROLLBACK_INPUTS
+    u8 inputs[2][ROLLBACK_INPUTS];
+    u64 received[ROLLBACK_INPUTS];  // Frame cuya entrada remota está ahí
+    u64 latest;             // Frame más reciente recibido
+    bool has_remote;
+
+    // Estadísticas
+    u64 rollbacks;          // Predicciones corregidas
+    u64 resimulated;        // Frames emulados otra vez
+    u32 max_resimulated;    // El rollback más largo (frames)
+    u64 rollback_ns;        // Tiempo total volviendo atrás
+    u64 max_rollback_ns;    // y el del rollback más lento
+    u64 stalls;             // Llamadas que no han podido avanzar
+} Rollback;
+
+// gb[0] y gb[1] tienen que empezar igual en los dos extremos (misma ROM y
+// mismo estado). max_frames entre 1 y ROLLBACK_MAX_FRAMES.
+bool rollback_init(Rollback* rb, GameBoy* gb0, GameBoy* gb1, u8 local,
+                   u32 max_frames, RollbackTransport transport);
+void rollback_free(Rollback* rb);
+
+// Recibe lo pendiente y corrige las predicciones que hayan fallado, sin
+// avanzar
+void rollback_update(Rollback* rb);
+
+// Un frame del host: rollback_update, y después emula un frame de las dos
+// consolas con los botones locales. Devuelve false si no se ha podido
+// avanzar (el otro va más de N frames por detrás, o el transporte no ha
+// aceptado la entrada); los botones se vuelven a pasar en la siguiente
+// llamada.
+bool rollback_frame(Rollback* rb, u8 buttons);
+
+// Todo lo emulado tiene ya la entrada de los dos confirmada
+static inline bool rollback_synced(const Rollback* rb) {
+    return rb->confirmed >= rb->frame && rb->rollback_from == UINT64_MAX;
+}
+
+// Transporte de pruebas: dos extremos en el mismo proceso, con un retardo
+// fijo en llamadas a loopback_tick (frames del host)
+#define LOOPBACK_CAPACITY 256
+
+typedef struct {
+    RollbackInput input;
+    u64 deliver;            // Se puede recibir cuando now >= deliver
+} LoopbackPacket;
+
+typedef struct LoopbackLink LoopbackLink;
+
+typedef struct {
+    LoopbackLink* link;
+    u8 side;
+} LoopbackEnd;
+
+struct LoopbackLink {
+    LoopbackPacket queue[2][LOOPBACK_CAPACITY]; // queue[i]: lo que recibe i
+    u32 head[2];
+    u32 count[2];
+    u32 delay;
+    u64 now;
+    LoopbackEnd ends[2];
+};
+
+void loopback_init(LoopbackLink* link, u32 delay);
+RollbackTransport loopback_transport(LoopbackLink* link, u8 side);
+void loopback_tick(LoopbackLink* link);
+
+#endif
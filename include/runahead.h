@@ -0,0 +1,41 @@
+#ifndef RUNAHEAD_H
+#define RUNAHEAD_H
+
+#include <stddef.h>
+#include "common.h"
+
+// Run-ahead: adelanta la imagen K frames para recortar la latencia de la
+// entrada. Cada frame se emula el de verdad con los botones actuales (sin
+// dibujar), se guarda el estado y se emulan K frames más con los mismos
+// botones; el último de ellos es el que se publica. Después se vuelve al
+// estado guardado, así que el juego avanza un frame por llamada y lo que se
+// ve es lo que mostraría K frames más tarde si no se tocara nada.
+// Los frames adelantados no generan audio: el sonido es el de los frames
+// de verdad y no se corta al volver atrás (gb_restore_state).
+
+// Más no tiene sentido: casi ningún juego tarda tanto en responder
+#define RUNAHEAD_MAX_FRAMES 8
+
+typedef struct {
+    u32 frames;       // K (0 = desactivado)
+    u8* state;        // Estado tras el frame de verdad
+    size_t size;
+
+    // Coste: tiempo de host fuera del frame de verdad
+    u64 extra_ns;
+    u64 frames_run;   // Llamadas a runahead_frame con K > 0
+} RunAhead;
+
+bool runahead_init(RunAhead* ra, const GameBoy* gb, u32 frames);
+void runahead_free(RunAhead* ra);
+
+// Emula un frame con los botones dados (JOYPAD_*) y publica el de K frames
+// más adelante. Devuelve los ticks del frame de verdad, como gb_run_frame.
+u64 runahead_frame(RunAhead* ra, GameBoy* gb, u8 buttons);
+
+// Coste medio por frame del run-ahead, en microsegundos
+static inline double runahead_extra_us(const RunAhead* ra) {
+    return ra->frames_run ? (double)ra->extra_ns / ra->frames_run / 1000.0 : 0.0;
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef SCALE_H
+#define SCALE_H
+
+#include "common.h"
+#include "framebuffer.h"
+#include "tile.h"
+
+// Escalado de frames exportados (previews, vídeo)
+// Trabaja sobre píxeles RGBA de 32 bits (fb_to_rgba). Igual que en tile.h,
+// Scale2x tiene kernels escalares y SIMD que se eligen según la CPU; los
+// nearest son solo escalares (con SSE2 no iban más rápido).
+
+typedef enum {
+    SCALE_NEAREST_2X = 0,
+    SCALE_NEAREST_3X,
+    SCALE_NEAREST_4X,
+    SCALE_SCALE2X,        // Scale2x / EPX: suaviza diagonales, 2x
+    SCALE_FILTER_COUNT
+} ScaleFilter;
+
+// Factor de ampliación del filtro (2, 3 o 4)
+int scale_factor(ScaleFilter filter);
+
+const char* scale_filter_name(ScaleFilter filter);
+
+// Filtro por nombre ("2x", "3x", "4x", "scale2x"); false si no existe
+bool scale_filter_parse(const char* name, ScaleFilter* filter);
+
+// Escala una imagen de width x height. out debe tener sitio para
+// (width * factor) x (height * factor) píxeles. width debe ser >= 2.
+void scale_image(ScaleFilter filter, const u32* in, int width, int height, u32* out);
+
+// Convierte el frame a RGBA en rgba (FB_PIXELS píxeles) y lo escala en out
+// (LCD_WIDTH * factor de ancho)
+void scale_frame(ScaleFilter filter, const Frame* frame, u32* rgba, u32* out);
+
+// Elige los kernels (mismos backends que tile.h; AVX2 usa los de SSE2).
+// Devuelve false si la CPU no soporta el backend.
+bool scale_set_backend(TileBackend backend);
+
+// Elige el mejor backend disponible, solo la primera vez (como tile_init)
+TileBackend scale_init(void);
+
+#endif
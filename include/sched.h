@@ -0,0 +1,39 @@
+#ifndef SCHED_H
+#define SCHED_H
+
+#include "common.h"
+
+// Planificador de eventos
+// En lugar de "avanzar" cada periférico en cada instrucción, los periféricos
+// programan el instante (en ticks) en el que tienen algo que hacer. La CPU
+// solo comprueba un único valor (next) tras cada instrucción.
+
+// Valor para indicar que un evento no está programado
+#define SCHED_NEVER UINT64_MAX
+
+// Tipos de evento (uno por periférico, cada uno con un único hueco)
+typedef enum {
+    EVENT_DMA = 0,      // Fin de la transferencia OAM DMA
+    EVENT_PPU,          // Cambio de modo de la PPU
+    EVENT_TIMER,        // Desbordamiento de TIMA
+    EVENT_SERIAL,       // Fin de una transferencia por el puerto serie
+    EVENT_COUNT
+} EventType;
+
+typedef struct {
+    u64 when[EVENT_COUNT]; // Instante (ticks) de cada evento, o SCHED_NEVER
+    u64 next;              // El más próximo de todos (caché de when[])
+} Scheduler;
+
+void sched_init(Scheduler* sched);
+
+// Programa (o reprograma) el evento type en el instante when
+void sched_schedule(GameBoy* gb, EventType type, u64 when);
+
+// Anula el evento type si estaba programado
+void sched_cancel(GameBoy* gb, EventType type);
+
+// Ejecuta todos los eventos vencidos (when <= gb->ticks)
+void sched_run(GameBoy* gb);
+
+#endif
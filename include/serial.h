@@ -0,0 +1,63 @@
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include "common.h"
+
+// Puerto serie (SB $FF01, SC $FF02) y cable link entre dos instancias
+// La consola que pone el reloj (SC bit 0 = interno) manda un byte cada
+// SERIAL_TRANSFER_TICKS; al acabar se intercambian los SB de las dos, se
+// limpia el bit 7 de SC y salta INT_SERIAL en ambas. La otra tiene que estar
+// esperando con reloj externo (SC = $80); si no, o si no hay nada conectado,
+// recibe $FF.
+// Las dos consolas no avanzan a la vez: cada una lleva su reloj y solo se
+// sincronizan al final de una transferencia. El fin se programa como evento
+// en las dos (también en la que se pone a esperar cuando la otra ya ha
+// empezado), y la primera que llega a él hace avanzar a la otra hasta el
+// mismo instante antes de intercambiar. Para que la otra nunca haya pasado ya
+// de ahí, serial_run_frame no deja que se separen más de SERIAL_QUANTUM
+// ticks (menos de lo que dura una transferencia); sin transferencias eso es
+// todo lo que cuesta el cable.
+
+#define REG_SB_ADDR 0xFF01
+#define REG_SC_ADDR 0xFF02
+
+// Índices en bus.io
+#define REG_SB 0x01
+#define REG_SC 0x02
+
+// Bits de SC
+#define SC_CLOCK 0 // 1 = reloj interno (esta consola manda)
+#define SC_START 7 // Transferencia en curso
+
+// 8 bits a 8192 Hz
+#define SERIAL_TRANSFER_TICKS 4096
+
+#define SERIAL_QUANTUM 2048
+
+typedef struct {
+    GameBoy* peer;  // Consola al otro lado del cable (NULL = nada)
+    u64 offset;     // peer->ticks - ticks en el mismo instante (módulo 2^64)
+} Serial;
+
+// Estado posterior a la boot ROM, sin cable
+void serial_init(GameBoy* gb);
+
+// Lectura y escritura de SB y SC
+u8 serial_read(GameBoy* gb, u16 address);
+void serial_write(GameBoy* gb, u16 address, u8 value);
+
+// Manejador del evento EVENT_SERIAL (fin de una transferencia)
+void serial_event(GameBoy* gb);
+
+// Conecta dos instancias (desconectando lo que tuvieran). El instante actual
+// de cada una pasa a ser el mismo. Los estados guardados no incluyen el
+// cable: una transferencia a medias se completa con lo que haya conectado.
+void serial_connect(GameBoy* a, GameBoy* b);
+void serial_disconnect(GameBoy* gb);
+
+// Como gb_run_frame, pero la consola conectada (si hay) avanza a la vez, a
+// tramos de SERIAL_QUANTUM. Con dos consolas conectadas hay que hacerlas
+// avanzar con esto, llamándolo solo con una de ellas.
+u64 serial_run_frame(GameBoy* gb);
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef STATE_H
+#define STATE_H
+
+#include <stddef.h>
+#include "common.h"
+#include "bus.h"
+
+// Estados guardados (save states)
+// Formato binario, little-endian, independiente de la disposición en
+// memoria de las estructuras:
+//   "GBST" u32 versión
+//   y una serie de secciones: etiqueta (4 caracteres) u32 longitud, datos
+// Cada periférico tiene su sección (CPU, BUS, CLK, DMA, TIMR, JOYP, PPU,
+// APU, CART, LCD). Al cargar se comprueba todo antes de tocar nada: si el
+// estado no es válido (otra versión, otra ROM, longitudes que no cuadran,
+// valores fuera de rango) la instancia queda como estaba. Las secciones desconocidas se ignoran.
+// La ROM no se guarda: el estado solo se puede cargar con la misma ROM.
+
+#define GB_STATE_MAGIC   "GBST"
+#define GB_STATE_VERSION 3
+
+// Tamaño exacto del estado de esta instancia (depende de la RAM externa)
+size_t gb_state_size(const GameBoy* gb);
+
+// Guarda el estado en buf. Devuelve los bytes escritos, o 0 si no cabe.
+size_t gb_save_state(const GameBoy* gb, u8* buf, size_t capacity);
+
+// Actualiza buf, que tiene un estado anterior de esta misma instancia: todo
+// menos la memoria se reescribe, y de la memoria solo se copian las páginas
+// marcadas en pages (normalmente bus.dirty desde que se guardó buf; véase
+// bus_clear_dirty). Devuelve false si buf no tiene la forma de un estado de
+// esta instancia.
+bool gb_update_state(const GameBoy* gb, u8* buf, size_t size, const u64* pages);
+
+// Restaura un estado guardado con gb_save_state. La instancia tiene que estar
+// inicializada (gb_init) y con la misma ROM cargada.
+bool gb_load_state(GameBoy* gb, const u8* data, size_t size);
+
+// Como gb_load_state, pero sin tocar la salida de audio: para volver a un
+// estado de esta misma instancia guardado tras apu_sync, sin que se haya
+// sintetizado nada desde entonces (run-ahead), o para volver a emular sin
+// audio lo ya sintetizado (rollback, véase apu_resume_output). El audio
+// sigue justo donde se quedó, sin cortes.
+bool gb_restore_state(GameBoy* gb, const u8* data, size_t size);
+
+// Hash de la memoria (VRAM, WRAM, OAM, HRAM y RAM externa) que guarda el de
+// cada página y solo recalcula las marcadas en pages (todas la primera vez,
+// o con pages == NULL). Sirve para comparar instancias sin copiar nada.
+typedef struct {
+    u64 page[BUS_PAGES];
+    bool valid;
+} MemoryHash;
+
+void memory_hash_init(MemoryHash* mh);
+u64 gb_memory_hash(const GameBoy* gb, MemoryHash* mh, const u64* pages);
+
+#endif
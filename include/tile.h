@@ -0,0 +1,43 @@
+#ifndef TILE_H
+#define TILE_H
+
+#include "common.h"
+
+// Kernels de gráficos: decodificación de tiles 2bpp, aplicación de paletas y
+// (des)empaquetado de los frames a 2 bits por píxel.
+// Hay una versión escalar portable y versiones SIMD para x86 que se eligen
+// en tiempo de ejecución según lo que soporte la CPU (CPUID).
+
+typedef enum {
+    TILE_BACKEND_SCALAR = 0,
+    TILE_BACKEND_SSE,    // SSE2 (decodificación) + SSSE3 (paletas)
+    TILE_BACKEND_AVX2,
+} TileBackend;
+
+// Decodifica rows filas de 2bpp planar (2 bytes por fila: plano bajo, plano
+// alto) a 8 índices de color (0-3) por fila. out debe tener rows * 8 bytes.
+extern void (*tile_decode_rows)(const u8* planar, u8* out, int rows);
+
+// Aplica una tabla de 16 entradas (tonos 0-3) a count píxeles y los
+// empaqueta a 2 bits: el píxel i va en los bits 2*(i%4) de out[i/4].
+// in[i] debe estar en el rango 0-15 y count ser múltiplo de 4.
+extern void (*tile_map_pack)(const u8* in, u8* out, const u8* lut, int count);
+
+// Operación inversa para los consumidores: desempaqueta count píxeles de
+// 2 bits y aplica una tabla de 4 entradas (out[i] = lut[píxel i]).
+extern void (*tile_unpack)(const u8* packed, u8* out, const u8* lut, int count);
+
+// Igual, pero con 4 bytes de salida por píxel (RGBA): out[i*4+c] = lut[píxel][c]
+extern void (*tile_unpack_rgba)(const u8* packed, u8* out, const u8 lut[4][4], int count);
+
+// Elige el mejor backend disponible. Devuelve el elegido. Solo lo fija la
+// primera vez; después no toca nada, así que una vez hecho (antes de
+// arrancar hilos) se puede llamar desde cualquiera.
+TileBackend tile_init(void);
+
+// Fuerza un backend concreto (benchmarks). Devuelve false si la CPU no lo soporta.
+bool tile_set_backend(TileBackend backend);
+
+const char* tile_backend_name(TileBackend backend);
+
+#endif
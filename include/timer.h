@@ -0,0 +1,42 @@
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "common.h"
+
+// Timer (DIV, TIMA, TMA, TAC)
+// No hay nada que avance por instrucción: el contador interno de 16 bits es
+// gb->ticks - div_base, DIV son sus 8 bits altos y TIMA se calcula contando
+// cuántos flancos de bajada del bit elegido por TAC ha habido desde la
+// última vez que se fijó. El desbordamiento de TIMA es un evento programado.
+
+// Registros (direcciones)
+#define REG_DIV_ADDR  0xFF04
+#define REG_TIMA_ADDR 0xFF05
+#define REG_TMA_ADDR  0xFF06
+#define REG_TAC_ADDR  0xFF07
+
+// Bits de TAC
+#define TAC_ENABLE 2
+
+typedef struct {
+    u64 div_base;   // Instante (ticks) en que el contador interno valía 0
+    u64 tima_time;  // Instante (ticks) en que TIMA valía tima
+    u8 tima;
+    u8 tma;
+    u8 tac;
+} Timer;
+
+// Estado posterior a la boot ROM
+void timer_init(GameBoy* gb);
+
+// Lectura y escritura de $FF04-$FF07
+u8 timer_read(GameBoy* gb, u16 address);
+void timer_write(GameBoy* gb, u16 address, u8 value);
+
+// Reinicia el contador interno (escritura en DIV, instrucción STOP)
+void timer_reset_div(GameBoy* gb);
+
+// Manejador del evento EVENT_TIMER (desbordamiento de TIMA)
+void timer_event(GameBoy* gb);
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef VIDEO_OUT_H
+#define VIDEO_OUT_H
+
+#include "common.h"
+#include "framebuffer.h"
+#include "scale.h"
+
+// Salida de vídeo en streaming (gameboy-emu --video-out)
+// La emulación solo copia cada frame (empaquetado, 5760 bytes) a un anillo
+// acotado; un hilo aparte lo convierte al formato de salida y hace los
+// write(). Si el hilo se queda atrás la emulación espera (no se pierde
+// ningún frame).
+
+#define VIDEO_RING_SIZE 16
+
+typedef enum {
+    VIDEO_FORMAT_Y4M = 0, // YUV4MPEG2 monocromo (Cmono), 1 byte de luma por píxel
+    VIDEO_FORMAT_RGB,     // RGB24 crudo, 3 bytes por píxel
+    VIDEO_FORMAT_INDEXED, // Tonos crudos (0-3), 1 byte por píxel
+} VideoFormat;
+
+typedef struct VideoOut VideoOut;
+
+// Abre path ("-" = stdout) y arranca el hilo de escritura. scale es un
+// ScaleFilter, o -1 para no escalar (el escalado lo hace el hilo; no vale con
+// VIDEO_FORMAT_INDEXED). rate_num/rate_den es la frecuencia de frames que se
+// anuncia en la cabecera Y4M.
+// Devuelve NULL si no se puede abrir. Para que el cierre de una tubería sea
+// un error de escritura y no mate el proceso, SIGPIPE debe estar ignorada
+// (lo hace main).
+VideoOut* video_out_open(const char* path, VideoFormat format, int scale, u32 rate_num, u32 rate_den);
+
+// Encola una copia del frame. Solo bloquea si el anillo está lleno.
+// Devuelve false si la escritura ha fallado (p. ej. el otro extremo de la
+// tubería se ha cerrado).
+bool video_out_push(VideoOut* video, const Frame* frame);
+
+// Escribe lo pendiente, para el hilo y cierra. Devuelve false si hubo errores.
+bool video_out_close(VideoOut* video);
+
+// Nombre de formato ("y4m", "rgb", "indexed"); false si no existe
+bool video_format_parse(const char* name, VideoFormat* format);
+
+#endif
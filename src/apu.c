@@ -0,0 +1,499 @@
+// src/apu.c
+#include <string.h>
+#include "gb.h"
+
+// Peso de cada unidad de salida de un canal (0-15) en la mezcla. Con los 4
+// canales a 15 y el volumen maestro a 8 quedan 15360: cabe en 16 bits.
+#define APU_AMP_SCALE 32
+
+// Bits que se leen siempre a 1 en $FF10-$FF2F
+static const u8 read_masks[0x20] = {
+    0x80, 0x3F, 0x00, 0xFF, 0xBF, // NR10-NR14
+    0xFF, 0x3F, 0x00, 0xFF, 0xBF, // NR20-NR24
+    0x7F, 0xFF, 0x9F, 0xFF, 0xBF, // NR30-NR34
+    0xFF, 0xFF, 0x00, 0x00, 0xBF, // NR40-NR44
+    0x00, 0x00, 0x70,             // NR50-NR52
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// Valores de $FF10-$FF25 tras la boot ROM
+static const u8 boot_registers[0x16] = {
+    0x80, 0xBF, 0xF3, 0xFF, 0xBF,
+    0xFF, 0x3F, 0x00, 0xFF, 0xBF,
+    0x7F, 0xFF, 0x9F, 0xFF, 0xBF,
+    0xFF, 0xFF, 0x00, 0x00, 0xBF,
+    0x77, 0xF3,
+};
+
+// Primer registro (NRx0) de cada canal
+static const u8 channel_base[APU_CHANNELS] = { 0x10, 0x15, 0x1A, 0x1F };
+
+static const u8 duty_table[4][8] = {
+    { 0, 0, 0, 0, 0, 0, 0, 1 }, // 12.5%
+    { 1, 0, 0, 0, 0, 0, 0, 1 }, // 25%
+    { 1, 0, 0, 0, 0, 1, 1, 1 }, // 50%
+    { 0, 1, 1, 1, 1, 1, 1, 0 }, // 75%
+};
+
+static const u8 noise_divisors[8] = { 8, 16, 32, 48, 64, 80, 96, 112 };
+
+// Con shift 14 y 15 el LFSR no recibe reloj
+#define NOISE_STOPPED (1ULL << 40)
+
+static bool apu_powered(GameBoy* gb) {
+    return BIT(gb->bus.io[REG_NR52], 7);
+}
+
+// ------------------------------ Mezcla ---------------------------------
+
+// Peso del canal n en cada lado según NR50 (volumen) y NR51 (panorámica)
+static void mix_levels(u8 nr50, u8 nr51, int n, int* left, int* right) {
+    *right = BIT(nr51, n)     ? ((nr50 & 7) + 1) * APU_AMP_SCALE : 0;
+    *left  = BIT(nr51, n + 4) ? (((nr50 >> 4) & 7) + 1) * APU_AMP_SCALE : 0;
+}
+
+// Salida actual del canal n (0-15)
+static i32 channel_output(GameBoy* gb, int n) {
+    ApuChannel* ch = &gb->apu.ch[n];
+    u8* io = gb->bus.io;
+    if (!ch->enabled) return 0;
+
+    switch (n) {
+        case APU_CH_WAVE: {
+            u8 code = (io[REG_NR32] >> 5) & 3;
+            if (code == 0) return 0;
+            u8 byte = io[REG_WAVE + ch->step / 2];
+            u8 sample = (ch->step & 1) ? (byte & 0x0F) : (byte >> 4);
+            return sample >> (code - 1);
+        }
+        case APU_CH_NOISE:
+            return (ch->lfsr & 1) ? 0 : ch->volume;
+        default: {
+            u8 duty = io[channel_base[n] + 1] >> 6;
+            return duty_table[duty][ch->step] ? ch->volume : 0;
+        }
+    }
+}
+
+// Envía al mezclador el cambio de salida del canal n en el instante when
+// (dentro del frame de síntesis que empieza en apu.time)
+static void channel_update(GameBoy* gb, int n, u64 when) {
+    Apu* apu = &gb->apu;
+    ApuChannel* ch = &apu->ch[n];
+    if (!apu->synth) return;
+
+    i32 amp = channel_output(gb, n);
+    i32 delta = amp - ch->amp;
+    if (delta == 0) return;
+    ch->amp = amp;
+
+    int left, right;
+    mix_levels(gb->bus.io[REG_NR50], gb->bus.io[REG_NR51], n, &left, &right);
+    u32 time = (u32)(when - apu->time);
+    if (left) blip_add_delta(&apu->left, time, delta * left);
+    if (right) blip_add_delta(&apu->right, time, delta * right);
+}
+
+// NR50 o NR51 han cambiado: se corrige la contribución de cada canal
+static void apu_remix(GameBoy* gb, u8 old_nr50, u8 old_nr51) {
+    Apu* apu = &gb->apu;
+    if (!apu->synth) return;
+
+    for (int n = 0; n < APU_CHANNELS; n++) {
+        int old_left, old_right, left, right;
+        mix_levels(old_nr50, old_nr51, n, &old_left, &old_right);
+        mix_levels(gb->bus.io[REG_NR50], gb->bus.io[REG_NR51], n, &left, &right);
+
+        i32 amp = apu->ch[n].amp;
+        if (left != old_left) blip_add_delta(&apu->left, 0, amp * (left - old_left));
+        if (right != old_right) blip_add_delta(&apu->right, 0, amp * (right - old_right));
+    }
+}
+
+static void channel_disable(GameBoy* gb, int n) {
+    gb->apu.ch[n].enabled = false;
+    channel_update(gb, n, gb->apu.time);
+}
+
+// ----------------------------- Generadores -----------------------------
+
+// Periodo (ticks) de un paso de la forma de onda del canal n
+static u64 channel_period(GameBoy* gb, int n) {
+    u8* io = gb->bus.io;
+    u8 base = channel_base[n];
+    u16 freq = io[base + 3] | ((io[base + 4] & 7) << 8);
+
+    switch (n) {
+        case APU_CH_WAVE:
+            return (2048 - freq) * 2;
+        case APU_CH_NOISE: {
+            u8 nr43 = io[REG_NR43];
+            if ((nr43 >> 4) >= 14) return NOISE_STOPPED;
+            return (u64)noise_divisors[nr43 & 7] << (nr43 >> 4);
+        }
+        default:
+            return (2048 - freq) * 4;
+    }
+}
+
+// Genera los cambios del canal n en [apu.time, end)
+static void run_channel(GameBoy* gb, int n, u64 end) {
+    ApuChannel* ch = &gb->apu.ch[n];
+    if (!ch->enabled || ch->next_edge >= end) return;
+
+    u64 period = channel_period(gb, n);
+    u8 length = (n == APU_CH_WAVE) ? 32 : 8;
+
+    // Cuadrada u onda en silencio: la posición avanza, pero no hay cambios
+    // que sintetizar
+    bool silent = (n == APU_CH_WAVE) ? ((gb->bus.io[REG_NR32] >> 5) & 3) == 0 : ch->volume == 0;
+    if (n != APU_CH_NOISE && silent) {
+        u64 steps = (end - 1 - ch->next_edge) / period + 1;
+        ch->step = (ch->step + steps) % length;
+        ch->next_edge += steps * period;
+        return;
+    }
+
+    bool short_lfsr = BIT(gb->bus.io[REG_NR43], 3);
+    while (ch->next_edge < end) {
+        if (n == APU_CH_NOISE) {
+            u16 bit = (ch->lfsr ^ (ch->lfsr >> 1)) & 1;
+            ch->lfsr = (ch->lfsr >> 1) | (bit << 14);
+            if (short_lfsr) ch->lfsr = (ch->lfsr & ~0x40) | (bit << 6);
+        }
+        else {
+            ch->step = (ch->step + 1) & (length - 1);
+        }
+        channel_update(gb, n, ch->next_edge);
+        ch->next_edge += period;
+    }
+}
+
+// ------------------------- Frame sequencer -----------------------------
+
+// Nueva frecuencia del sweep; si desborda, apaga el canal 1
+static u16 sweep_calc(GameBoy* gb) {
+    Apu* apu = &gb->apu;
+    u8 nr10 = gb->bus.io[REG_NR10];
+    u16 delta = apu->sweep_shadow >> (nr10 & 7);
+    u16 freq = BIT(nr10, 3) ? apu->sweep_shadow - delta : apu->sweep_shadow + delta;
+
+    if (freq > 2047) channel_disable(gb, APU_CH_SQUARE1);
+    return freq;
+}
+
+static void clock_sweep(GameBoy* gb) {
+    Apu* apu = &gb->apu;
+    u8* io = gb->bus.io;
+    u8 period = (io[REG_NR10] >> 4) & 7;
+
+    if (--apu->sweep_timer > 0) return;
+    apu->sweep_timer = period ? period : 8;
+
+    if (!apu->sweep_enabled || !period || !apu->ch[APU_CH_SQUARE1].enabled) return;
+
+    u16 freq = sweep_calc(gb);
+    if (freq <= 2047 && (io[REG_NR10] & 7)) {
+        apu->sweep_shadow = freq;
+        io[REG_NR13] = freq & 0xFF;
+        io[REG_NR14] = (io[REG_NR14] & ~7) | (freq >> 8);
+        sweep_calc(gb);
+    }
+}
+
+static void clock_lengths(GameBoy* gb) {
+    for (int n = 0; n < APU_CHANNELS; n++) {
+        ApuChannel* ch = &gb->apu.ch[n];
+        if (ch->length_enable && ch->length > 0 && --ch->length == 0) {
+            channel_disable(gb, n);
+        }
+    }
+}
+
+static void clock_envelopes(GameBoy* gb) {
+    for (int n = 0; n < APU_CHANNELS; n++) {
+        ApuChannel* ch = &gb->apu.ch[n];
+        if (n == APU_CH_WAVE || !ch->env_period) continue;
+        if (--ch->env_timer > 0) continue;
+
+        ch->env_timer = ch->env_period;
+        if (ch->env_up && ch->volume < 15) ch->volume++;
+        else if (!ch->env_up && ch->volume > 0) ch->volume--;
+        channel_update(gb, n, gb->apu.time);
+    }
+}
+
+// Pasos: duración en los pares, sweep en 2 y 6, envolvente en 7
+static void sequencer_step(GameBoy* gb) {
+    u8 step = gb->apu.seq_step;
+    gb->apu.seq_step = (step + 1) & 7;
+
+    if ((step & 1) == 0) clock_lengths(gb);
+    if (step == 2 || step == 6) clock_sweep(gb);
+    if (step == 7) clock_envelopes(gb);
+}
+
+// ------------------------------ Síntesis -------------------------------
+
+void apu_sync(GameBoy* gb) {
+    Apu* apu = &gb->apu;
+    bool powered = apu_powered(gb);
+
+    // Por tramos que acaban, como mucho, en el siguiente paso del sequencer.
+    // Sin audio solo queda el sequencer: un paso cada APU_SEQ_TICKS.
+    while (apu->time < gb->ticks) {
+        u64 end = gb->ticks < apu->next_seq ? gb->ticks : apu->next_seq;
+
+        if (apu->synth) {
+            if (powered) {
+                for (int n = 0; n < APU_CHANNELS; n++) run_channel(gb, n, end);
+            }
+            blip_end_frame(&apu->left, (u32)(end - apu->time));
+            blip_end_frame(&apu->right, (u32)(end - apu->time));
+        }
+        apu->time = end;
+
+        if (end == apu->next_seq) {
+            if (powered) sequencer_step(gb);
+            apu->next_seq += APU_SEQ_TICKS;
+        }
+
+        // Si nadie saca muestras se descartan las más antiguas
+        if (apu->left.avail > BLIP_CAPACITY / 2) {
+            int drop = apu->left.avail - BLIP_CAPACITY / 4;
+            blip_read(&apu->left, NULL, drop, 1);
+            blip_read(&apu->right, NULL, drop, 1);
+        }
+    }
+}
+
+int apu_samples_available(GameBoy* gb) {
+    apu_sync(gb);
+    return gb->apu.left.avail;
+}
+
+void apu_set_rate_adjust(GameBoy* gb, double ratio) {
+    Apu* apu = &gb->apu;
+    apu_sync(gb);
+
+    u64 factor = (u64)(blip_factor(APU_CLOCK_RATE, apu->sample_rate) * ratio + 0.5);
+    blip_set_factor(&apu->left, factor);
+    blip_set_factor(&apu->right, factor);
+}
+
+void apu_set_synth(GameBoy* gb, bool enabled) {
+    Apu* apu = &gb->apu;
+    apu_sync(gb);
+    if (apu->synth == enabled) return;
+    apu->synth = enabled;
+
+    // Sin audio los generadores no han avanzado: retoman la fase desde ahora
+    if (enabled) {
+        for (int n = 0; n < APU_CHANNELS; n++) {
+            apu->ch[n].next_edge = gb->ticks + channel_period(gb, n);
+        }
+    }
+    apu_reset_output(gb);
+}
+
+void apu_reset_output(GameBoy* gb) {
+    Apu* apu = &gb->apu;
+
+    // Se conserva el ajuste de ritmo (apu_set_rate_adjust)
+    u64 factor = apu->left.factor;
+    blip_init(&apu->left, APU_CLOCK_RATE, apu->sample_rate);
+    blip_init(&apu->right, APU_CLOCK_RATE, apu->sample_rate);
+    blip_set_factor(&apu->left, factor);
+    blip_set_factor(&apu->right, factor);
+
+    for (int n = 0; n < APU_CHANNELS; n++) {
+        // Un estado guardado sin audio trae la fase parada
+        if (apu->synth && apu->ch[n].next_edge < apu->time) {
+            apu->ch[n].next_edge = apu->time + channel_period(gb, n);
+        }
+        apu->ch[n].amp = 0;
+        channel_update(gb, n, apu->time);
+    }
+}
+
+void apu_resume_output(GameBoy* gb) {
+    Apu* apu = &gb->apu;
+    if (!apu->synth) return;
+
+    for (int n = 0; n < APU_CHANNELS; n++) {
+        if (apu->ch[n].next_edge < apu->time) {
+            apu->ch[n].next_edge = apu->time + channel_period(gb, n);
+        }
+        channel_update(gb, n, apu->time);
+    }
+}
+
+int apu_read_samples(GameBoy* gb, i16* out, int frames) {
+    apu_sync(gb);
+    int count = blip_read(&gb->apu.left, out, frames, 2);
+    blip_read(&gb->apu.right, out + 1, count, 2);
+    return count;
+}
+
+// ----------------------------- Registros -------------------------------
+
+static void channel_trigger(GameBoy* gb, int n) {
+    Apu* apu = &gb->apu;
+    ApuChannel* ch = &apu->ch[n];
+    u8* io = gb->bus.io;
+    u8 base = channel_base[n];
+
+    ch->enabled = ch->dac;
+    if (ch->length == 0) ch->length = (n == APU_CH_WAVE) ? 256 : 64;
+    ch->next_edge = gb->ticks + channel_period(gb, n);
+
+    if (n == APU_CH_WAVE) {
+        ch->step = 0;
+    }
+    else {
+        u8 nrx2 = io[base + 2];
+        ch->volume = nrx2 >> 4;
+        ch->env_up = BIT(nrx2, 3);
+        ch->env_period = nrx2 & 7;
+        ch->env_timer = ch->env_period ? ch->env_period : 8;
+    }
+    if (n == APU_CH_NOISE) ch->lfsr = 0x7FFF;
+
+    if (n == APU_CH_SQUARE1) {
+        u8 period = (io[REG_NR10] >> 4) & 7;
+        u8 shift = io[REG_NR10] & 7;
+        apu->sweep_shadow = io[REG_NR13] | ((io[REG_NR14] & 7) << 8);
+        apu->sweep_timer = period ? period : 8;
+        apu->sweep_enabled = period || shift;
+        if (shift) sweep_calc(gb);
+    }
+}
+
+static void apu_power(GameBoy* gb, bool on) {
+    u8* io = gb->bus.io;
+    if (on == apu_powered(gb)) return;
+
+    if (on) {
+        io[REG_NR52] = 0x80;
+        gb->apu.seq_step = 0;
+        return;
+    }
+
+    // Apagar: se pierden todos los registros (salvo la Wave RAM)
+    for (int n = 0; n < APU_CHANNELS; n++) {
+        channel_disable(gb, n);
+        gb->apu.ch[n].dac = false;
+        gb->apu.ch[n].length = 0;
+        gb->apu.ch[n].length_enable = false;
+    }
+    memset(&io[REG_NR10], 0, REG_NR52 - REG_NR10);
+    io[REG_NR52] = 0;
+}
+
+u8 apu_read(GameBoy* gb, u16 address) {
+    u8 reg = address & 0xFF;
+    u8* io = gb->bus.io;
+
+    if (reg >= REG_WAVE) return io[reg];
+
+    // NR52: los bits de estado dependen de los contadores de duración
+    if (reg == REG_NR52) {
+        apu_sync(gb);
+        u8 status = io[REG_NR52] | read_masks[reg - REG_NR10];
+        for (int n = 0; n < APU_CHANNELS; n++) {
+            if (gb->apu.ch[n].enabled) status |= 1 << n;
+        }
+        return status;
+    }
+
+    return io[reg] | read_masks[reg - REG_NR10];
+}
+
+void apu_write(GameBoy* gb, u16 address, u8 value) {
+    u8 reg = address & 0xFF;
+    u8* io = gb->bus.io;
+
+    // Todo lo anterior a la escritura se sintetiza con los valores antiguos
+    apu_sync(gb);
+
+    if (reg >= REG_WAVE) {
+        io[reg] = value;
+        return;
+    }
+    if (reg == REG_NR52) {
+        apu_power(gb, BIT(value, 7));
+        return;
+    }
+    // Con la APU apagada los registros no se pueden escribir
+    if (!apu_powered(gb)) return;
+
+    u8 old = io[reg];
+    io[reg] = value;
+
+    if (reg == REG_NR50 || reg == REG_NR51) {
+        apu_remix(gb, reg == REG_NR50 ? old : io[REG_NR50], reg == REG_NR51 ? old : io[REG_NR51]);
+        return;
+    }
+    if (reg > REG_NR44) return; // $FF27-$FF2F no existen
+
+    int n = (reg - REG_NR10) / 5;
+    ApuChannel* ch = &gb->apu.ch[n];
+
+    switch ((reg - REG_NR10) % 5) {
+        case 0: // NR30: DAC del canal de onda
+            if (n == APU_CH_WAVE) {
+                ch->dac = BIT(value, 7);
+                if (!ch->dac) ch->enabled = false;
+            }
+            break;
+        case 1: // Duración (y duty en las cuadradas)
+            ch->length = (n == APU_CH_WAVE) ? 256 - value : 64 - (value & 0x3F);
+            break;
+        case 2: // Envolvente (volumen en el canal de onda)
+            if (n != APU_CH_WAVE) {
+                ch->dac = (value & 0xF8) != 0;
+                if (!ch->dac) ch->enabled = false;
+            }
+            break;
+        case 4: // Control: activar duración y trigger
+            ch->length_enable = BIT(value, 6);
+            if (BIT(value, 7)) channel_trigger(gb, n);
+            break;
+    }
+
+    // El duty, el volumen del canal de onda o el propio trigger pueden
+    // cambiar la salida en este mismo instante
+    channel_update(gb, n, gb->ticks);
+}
+
+void apu_reset_div(GameBoy* gb) {
+    apu_sync(gb);
+    gb->apu.next_seq = gb->ticks + APU_SEQ_TICKS;
+}
+
+void apu_init(GameBoy* gb, u32 sample_rate) {
+    Apu* apu = &gb->apu;
+    u8* io = gb->bus.io;
+
+    if (sample_rate == 0) sample_rate = APU_DEFAULT_SAMPLE_RATE;
+    if (sample_rate > APU_MAX_SAMPLE_RATE) sample_rate = APU_MAX_SAMPLE_RATE;
+
+    memset(apu, 0, sizeof(*apu));
+    apu->synth = true;
+    apu->sample_rate = sample_rate;
+    blip_init(&apu->left, APU_CLOCK_RATE, sample_rate);
+    blip_init(&apu->right, APU_CLOCK_RATE, sample_rate);
+
+    // El sequencer avanza con el bit 12 del divisor del timer
+    apu->time = gb->ticks;
+    u64 counter = gb->ticks - gb->timer.div_base;
+    apu->next_seq = gb->ticks + (APU_SEQ_TICKS - counter % APU_SEQ_TICKS);
+
+    memcpy(&io[REG_NR10], boot_registers, sizeof(boot_registers));
+    io[REG_NR52] = 0x80;
+
+    // El sonido de arranque deja el canal 1 activo (y ya en silencio)
+    apu->ch[APU_CH_SQUARE1].enabled = true;
+    apu->ch[APU_CH_SQUARE1].dac = true;
+    apu->ch[APU_CH_NOISE].lfsr = 0x7FFF;
+}
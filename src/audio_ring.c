@@ -0,0 +1,89 @@
+// src/audio_ring.c
+#include <string.h>
+#include "gb.h"
+#include "audio_ring.h"
+
+#define RING_MASK (AUDIO_RING_FRAMES - 1)
+
+void audio_ring_init(AudioRing* ring, u32 target) {
+    memset(ring, 0, sizeof(*ring));
+    if (target == 0 || target > AUDIO_RING_FRAMES / 2) target = AUDIO_RING_FRAMES / 4;
+    ring->target = target;
+}
+
+u32 audio_ring_fill(const AudioRing* ring) {
+    u64 head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    u64 tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    return (u32)(head - tail);
+}
+
+// Copia count frames entre el anillo (a partir del índice start) y buf
+static void ring_copy(i16* ring, u64 start, i16* buf, int count, bool to_ring) {
+    u32 index = start & RING_MASK;
+    int first = AUDIO_RING_FRAMES - index;
+    if (first > count) first = count;
+
+    if (to_ring) {
+        memcpy(&ring[index * 2], buf, first * 2 * sizeof(i16));
+        memcpy(ring, &buf[first * 2], (count - first) * 2 * sizeof(i16));
+    }
+    else {
+        memcpy(buf, &ring[index * 2], first * 2 * sizeof(i16));
+        memcpy(&buf[first * 2], ring, (count - first) * 2 * sizeof(i16));
+    }
+}
+
+int audio_ring_write(AudioRing* ring, const i16* frames, int count) {
+    // head es nuestro; tail puede avanzar mientras tanto (solo deja más sitio)
+    u64 head = ring->head;
+    u64 tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    int space = AUDIO_RING_FRAMES - (int)(head - tail);
+
+    if (count > space) {
+        ring->overruns += count - space;
+        count = space;
+    }
+
+    ring_copy(ring->samples, head, (i16*)frames, count, true);
+    // El RELEASE hace visibles las muestras antes que el nuevo head
+    __atomic_store_n(&ring->head, head + count, __ATOMIC_RELEASE);
+    return count;
+}
+
+int audio_ring_read(AudioRing* ring, i16* out, int count) {
+    u64 tail = ring->tail;
+    u64 head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    int available = (int)(head - tail);
+    int n = count < available ? count : available;
+
+    ring_copy(ring->samples, tail, out, n, false);
+    __atomic_store_n(&ring->tail, tail + n, __ATOMIC_RELEASE);
+
+    if (n > 0) memcpy(ring->last, &out[(n - 1) * 2], sizeof(ring->last));
+    for (int i = n; i < count; i++) {
+        memcpy(&out[i * 2], ring->last, sizeof(ring->last));
+    }
+    ring->underruns += count - n;
+    return n;
+}
+
+double audio_ring_rate_adjust(const AudioRing* ring) {
+    // Proporcional al error: vacío -> +MAX, el doble del objetivo -> -MAX
+    double error = ((double)ring->target - (double)audio_ring_fill(ring)) / ring->target;
+    if (error > 1.0) error = 1.0;
+    if (error < -1.0) error = -1.0;
+    return 1.0 + AUDIO_RING_MAX_ADJUST * error;
+}
+
+int audio_ring_pump(AudioRing* ring, GameBoy* gb) {
+    i16 frames[1024 * 2];
+    int total = 0;
+
+    int n;
+    while ((n = apu_read_samples(gb, frames, 1024)) > 0) {
+        total += audio_ring_write(ring, frames, n);
+    }
+
+    apu_set_rate_adjust(gb, audio_ring_rate_adjust(ring));
+    return total;
+}
@@ -0,0 +1,286 @@
+// src/batch.c
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include "gb.h"
+#include "host_clock.h"
+#include "state.h"
+#include "movie.h"
+#include "tile.h"
+#include "pool.h"
+#include "batch.h"
+
+#define BATCH_LINE_MAX 4096
+
+typedef struct {
+    // Del fichero
+    int line;
+    char* rom;
+    u64 frames;
+    char* movie_path;   // NULL = sin película
+    bool seeded;
+    u32 seed;
+    char* output;       // NULL = sin salida
+
+    // En ejecución (solo lo toca el hilo que tiene la tarea)
+    GameBoy* gb;
+    Movie movie;
+    u64 done;
+    u32 rng;
+    u8 buttons;
+
+    // Resultado
+    bool failed;
+    u64 hash;
+} BatchJob;
+
+static char* copy_string(const char* s) {
+    size_t size = strlen(s) + 1;
+    char* copy = malloc(size);
+    if (copy) memcpy(copy, s, size);
+    return copy;
+}
+
+// ------------------------------ Trabajos -------------------------------
+
+// Una línea del fichero. Devuelve false si está mal.
+static bool parse_job(BatchJob* job, char* text, int line) {
+    memset(job, 0, sizeof(*job));
+    job->line = line;
+
+    char* fields[4] = { 0 };
+    int count = 0;
+    for (char* field = strtok(text, " \t\r\n"); field; field = strtok(NULL, " \t\r\n")) {
+        if (count == 4) return false;
+        fields[count++] = field;
+    }
+    if (count < 2) return false;
+
+    char* end;
+    job->frames = strtoull(fields[1], &end, 10);
+    if (*end != '\0' || job->frames == 0) return false;
+
+    job->rom = copy_string(fields[0]);
+    if (fields[2] && strncmp(fields[2], "seed=", 5) == 0) {
+        job->seeded = true;
+        job->seed = (u32)strtoul(fields[2] + 5, NULL, 10);
+    }
+    else if (fields[2] && strcmp(fields[2], "-") != 0) {
+        job->movie_path = copy_string(fields[2]);
+    }
+    if (fields[3] && strcmp(fields[3], "-") != 0) {
+        job->output = copy_string(fields[3]);
+    }
+    return job->rom != NULL;
+}
+
+static void free_job(BatchJob* job) {
+    free(job->rom);
+    free(job->movie_path);
+    free(job->output);
+}
+
+static BatchJob* load_jobs(const char* path, int* count) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        fprintf(stderr, "No se puede abrir la lista de trabajos: %s\n", path);
+        return NULL;
+    }
+
+    BatchJob* jobs = NULL;
+    int capacity = 0;
+    *count = 0;
+    char text[BATCH_LINE_MAX];
+    bool ok = true;
+    for (int line = 1; ok && fgets(text, sizeof(text), file); line++) {
+        char* start = text + strspn(text, " \t\r\n");
+        if (*start == '\0' || *start == '#') continue;
+
+        if (*count == capacity) {
+            capacity = capacity ? capacity * 2 : 64;
+            BatchJob* grown = realloc(jobs, sizeof(BatchJob) * capacity);
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            jobs = grown;
+        }
+        if (!parse_job(&jobs[*count], start, line)) {
+            fprintf(stderr, "%s:%d: se esperaba <rom> <frames> [entrada] [salida]\n", path, line);
+            free_job(&jobs[*count]);
+            ok = false;
+            break;
+        }
+        (*count)++;
+    }
+    fclose(file);
+
+    if (!ok) {
+        for (int i = 0; i < *count; i++) free_job(&jobs[i]);
+        free(jobs);
+        return NULL;
+    }
+    return jobs;
+}
+
+// ------------------------------ Ejecución ------------------------------
+
+static bool start_job(BatchJob* job) {
+    job->gb = malloc(sizeof(GameBoy));
+    if (!job->gb) return false;
+
+    GbConfig config = { .no_audio = true };
+    gb_init(job->gb, &config);
+    if (!cart_load(&job->gb->cart, job->rom)) return false;
+    ppu_set_render_policy(job->gb, PPU_RENDER_NEVER, 0);
+
+    movie_init(&job->movie, 0);
+    if (job->movie_path) {
+        if (!movie_load(&job->movie, job->movie_path) || !movie_seek(&job->movie, job->gb, 0)) {
+            fprintf(stderr, "Línea %d: no se puede usar la película %s\n", job->line, job->movie_path);
+            return false;
+        }
+    }
+    job->rng = job->seed ? job->seed : 1;
+    return true;
+}
+
+// Botones del siguiente frame
+static u8 next_input(BatchJob* job) {
+    if (job->movie.position < job->movie.frames) {
+        return job->movie.inputs[job->movie.position++];
+    }
+    if (job->seeded) {
+        // xorshift32; cada frame, 1 de cada 16 veces cambian los botones
+        job->rng ^= job->rng << 13;
+        job->rng ^= job->rng >> 17;
+        job->rng ^= job->rng << 5;
+        if ((job->rng & 15) == 0) job->buttons = (u8)(job->rng >> 8);
+        return job->buttons;
+    }
+    return 0;
+}
+
+static void finish_job(BatchJob* job) {
+    if (job->gb && !job->failed) {
+        MemoryHash mh;
+        memory_hash_init(&mh);
+        job->hash = gb_memory_hash(job->gb, &mh, NULL);
+
+        if (job->output) {
+            size_t size = gb_state_size(job->gb);
+            u8* state = malloc(size);
+            FILE* file = state ? fopen(job->output, "wb") : NULL;
+            bool ok = file && gb_save_state(job->gb, state, size) && fwrite(state, 1, size, file) == size;
+            if (file && fclose(file) != 0) ok = false;
+            if (!ok) {
+                fprintf(stderr, "Línea %d: no se puede escribir %s\n", job->line, job->output);
+                job->failed = true;
+            }
+            free(state);
+        }
+    }
+
+    movie_free(&job->movie);
+    if (job->gb) {
+        cart_free(&job->gb->cart);
+        free(job->gb);
+        job->gb = NULL;
+    }
+}
+
+static u32 slice_frames = BATCH_SLICE_FRAMES;
+
+// Un tramo de un trabajo (tarea del pool)
+static bool run_slice(void* arg, int worker) {
+    (void)worker;
+    BatchJob* job = arg;
+
+    if (!job->gb && !start_job(job)) {
+        job->failed = true;
+        finish_job(job);
+        return false;
+    }
+
+    u64 end = job->done + slice_frames;
+    if (end > job->frames) end = job->frames;
+    for (; job->done < end; job->done++) {
+        joypad_set(job->gb, next_input(job));
+        gb_run_frame(job->gb);
+    }
+
+    if (job->done < job->frames) return true;
+    finish_job(job);
+    return false;
+}
+
+// ------------------------------ Interfaz -------------------------------
+
+int batch_main(int argc, char** argv) {
+    const char* path = NULL;
+    int threads = 0;
+
+    for (int i = 0; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--threads") == 0 && has_value) {
+            threads = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--slice") == 0 && has_value) {
+            slice_frames = (u32)strtoul(argv[++i], NULL, 10);
+            if (slice_frames == 0) slice_frames = BATCH_SLICE_FRAMES;
+        }
+        else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, "Opción desconocida o sin valor: %s\n", argv[i]);
+            return 1;
+        }
+        else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        fprintf(stderr, "Uso: gameboy-emu batch <trabajos> [--threads N] [--slice F]\n");
+        return 1;
+    }
+
+    // Los kernels SIMD se eligen antes de arrancar los hilos
+    tile_init();
+
+    int count;
+    BatchJob* jobs = load_jobs(path, &count);
+    if (!jobs) return 1;
+
+    WorkPool* pool = pool_create(threads, (u32)count);
+    if (!pool) {
+        for (int i = 0; i < count; i++) free_job(&jobs[i]);
+        free(jobs);
+        return 1;
+    }
+    for (int i = 0; i < count; i++) pool_submit(pool, run_slice, &jobs[i]);
+
+    u64 start = now_ns();
+    pool_run(pool);
+    double seconds = (double)(now_ns() - start) / 1e9;
+
+    u64 frames = 0;
+    int failed = 0;
+    for (int i = 0; i < count; i++) {
+        BatchJob* job = &jobs[i];
+        if (job->failed) {
+            printf("%4d %-32s %10llu %16s\n", job->line, job->rom, (unsigned long long)job->done, "FALLO");
+            failed++;
+        }
+        else {
+            printf("%4d %-32s %10llu %016llx\n", job->line, job->rom, (unsigned long long)job->done,
+                   (unsigned long long)job->hash);
+        }
+        frames += job->done;
+    }
+    printf("%d trabajos (%d fallidos), %llu frames en %.2f s: %.0f frames/s con %d hilos (%llu robos)\n",
+           count, failed, (unsigned long long)frames, seconds, seconds > 0 ? frames / seconds : 0.0,
+           pool_threads(pool), (unsigned long long)pool_steals(pool));
+
+    pool_destroy(pool);
+    for (int i = 0; i < count; i++) free_job(&jobs[i]);
+    free(jobs);
+    return failed ? 1 : 0;
+}
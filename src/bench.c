@@ -0,0 +1,1090 @@
+// src/bench.c
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "gb.h"
+#include "host_clock.h"
+#include "bench.h"
+#include "tile.h"
+#include "scale.h"
+#include "audio_ring.h"
+#include "state.h"
+#include "rewind.h"
+#include "movie.h"
+#include "runahead.h"
+#include "rollback.h"
+#include "pool.h"
+
+// Evita que el compilador descarte los resultados
+static volatile u8 bench_sink;
+
+// ------------------------------ tiles ----------------------------------
+// Decodificación de los 384 tiles, paleta + empaquetado de las 144 líneas y
+// conversión de un frame empaquetado a RGBA, con cada backend disponible.
+static void bench_tiles(void) {
+    const int iterations = 2000;
+
+    static u8 vram[TILE_COUNT * 16];
+    static u8 tiles[TILE_COUNT * 64];
+    static u8 line[LCD_WIDTH];
+    static u8 out[LCD_WIDTH / 4];
+    static Frame frame;
+    static u8 rgba[FB_PIXELS * 4];
+    u8 lut[16] = { 0, 1, 2, 3, 3, 2, 1, 0, 0, 2, 1, 3 };
+
+    srand(1234);
+    for (int i = 0; i < (int)sizeof(vram); i++) vram[i] = rand();
+    for (int i = 0; i < LCD_WIDTH; i++) line[i] = rand() % 12;
+    for (int i = 0; i < FB_FRAME_BYTES; i++) (&frame.pixels[0][0])[i] = rand();
+    for (int i = 0; i < 16; i++) frame.palette[i / 4][i % 4] = rand();
+
+    static u8 reference[TILE_COUNT * 64];
+    static u8 reference_out[LCD_WIDTH / 4];
+    static u8 reference_rgba[FB_PIXELS * 4];
+    double scalar_decode = 0, scalar_map = 0, scalar_rgba = 0;
+
+    printf("%-8s %14s %14s %14s\n", "backend", "ns/tile", "ns/scanline", "us/rgba frame");
+    for (int b = TILE_BACKEND_SCALAR; b <= TILE_BACKEND_AVX2; b++) {
+        if (!tile_set_backend(b)) {
+            printf("%-8s %14s %14s %14s\n", tile_backend_name(b), "n/a", "n/a", "n/a");
+            continue;
+        }
+
+        u64 start = now_ns();
+        for (int it = 0; it < iterations; it++) {
+            tile_decode_rows(vram, tiles, TILE_COUNT * 8);
+            bench_sink = tiles[it % sizeof(tiles)];
+        }
+        double decode = (double)(now_ns() - start) / ((double)iterations * TILE_COUNT);
+
+        start = now_ns();
+        for (int it = 0; it < iterations; it++) {
+            for (int y = 0; y < LCD_HEIGHT; y++) {
+                tile_map_pack(line, out, lut, LCD_WIDTH);
+                bench_sink = out[y % sizeof(out)];
+            }
+        }
+        double map = (double)(now_ns() - start) / ((double)iterations * LCD_HEIGHT);
+
+        start = now_ns();
+        for (int it = 0; it < iterations / 10; it++) {
+            fb_to_rgba(&frame, rgba);
+            bench_sink = rgba[it];
+        }
+        double convert = (double)(now_ns() - start) / (iterations / 10) / 1000.0;
+
+        // Todos los backends deben dar exactamente lo mismo que el escalar
+        if (b == TILE_BACKEND_SCALAR) {
+            memcpy(reference, tiles, sizeof(tiles));
+            memcpy(reference_out, out, sizeof(out));
+            memcpy(reference_rgba, rgba, sizeof(rgba));
+            scalar_decode = decode;
+            scalar_map = map;
+            scalar_rgba = convert;
+            printf("%-8s %14.2f %14.2f %14.2f\n", tile_backend_name(b), decode, map, convert);
+        }
+        else {
+            bool same = memcmp(reference, tiles, sizeof(tiles)) == 0
+                     && memcmp(reference_out, out, sizeof(out)) == 0
+                     && memcmp(reference_rgba, rgba, sizeof(rgba)) == 0;
+            printf("%-8s %14.2f %14.2f %14.2f   x%.1f / x%.1f / x%.1f%s\n", tile_backend_name(b),
+                   decode, map, convert, scalar_decode / decode, scalar_map / map,
+                   scalar_rgba / convert, same ? "" : "  MISMATCH");
+        }
+    }
+
+    tile_set_backend(tile_init());
+}
+
+// ------------------------------ frames ---------------------------------
+// Coste por frame emulado según backend y política de dibujado. La CPU
+// ejecuta un bucle de NOPs en WRAM sobre una escena aleatoria con sprites.
+
+// Escena aleatoria común a varios benchmarks
+static void bench_scene(GameBoy* gb) {
+    // $C000: 16 x NOP; JR $C000
+    for (int i = 0; i < 16; i++) gb->bus.wram[i] = 0x00;
+    gb->bus.wram[16] = 0x18;
+    gb->bus.wram[17] = (u8)-18;
+    gb->cpu.pc = 0xC000;
+
+    srand(42);
+    for (int a = 0x8000; a < 0xA000; a++) bus_write(gb, a, rand());
+    for (int i = 0; i < OAM_SIZE; i++) bus_write(gb, 0xFE00 + i, rand() % 170);
+    bus_write(gb, 0xFF47, 0xE4);
+    bus_write(gb, 0xFF48, 0xD2);
+    bus_write(gb, 0xFF49, 0x1B);
+    bus_write(gb, 0xFF40, 0x93);
+}
+
+static void bench_frames(void) {
+    const int frames = 300;
+    static GameBoy gb;
+
+    const struct { const char* name; PpuRenderPolicy policy; u32 interval; } policies[] = {
+        { "all",     PPU_RENDER_ALL,     0 },
+        { "every-4", PPU_RENDER_EVERY_N, 4 },
+        { "never",   PPU_RENDER_NEVER,   0 },
+    };
+    const PpuBackend backends[] = { PPU_BACKEND_FAST, PPU_BACKEND_FIFO };
+
+    printf("%-8s %-8s %14s\n", "backend", "render", "us/frame");
+    for (int b = 0; b < 2; b++) {
+        for (int p = 0; p < 3; p++) {
+            GbConfig config = { .ppu_backend = backends[b] };
+            gb_init(&gb, &config);
+            bench_scene(&gb);
+            ppu_set_render_policy(&gb, policies[p].policy, policies[p].interval);
+            gb_run_frame(&gb);
+
+            u64 start = now_ns();
+            for (int f = 0; f < frames; f++) {
+                gb_run_frame(&gb);
+            }
+            double us = (double)(now_ns() - start) / frames / 1000.0;
+
+            printf("%-8s %-8s %14.2f\n", b ? "fifo" : "fast", policies[p].name, us);
+        }
+    }
+}
+
+// ---------------------------- linecache --------------------------------
+// Caché de líneas con una escena estática y con scroll horizontal continuo
+
+static void bench_linecache(void) {
+    const int frames = 300;
+    static GameBoy gb;
+
+    printf("%-10s %-6s %14s %10s\n", "scene", "cache", "us/frame", "hit rate");
+    for (int scroll = 0; scroll < 2; scroll++) {
+        for (int cache = 0; cache < 2; cache++) {
+            gb_init(&gb, NULL);
+            bench_scene(&gb);
+            ppu_set_line_cache(&gb, cache);
+            gb_run_frame(&gb);
+            gb.ppu.line_cache_hits = gb.ppu.line_cache_misses = 0;
+
+            u64 start = now_ns();
+            for (int f = 0; f < frames; f++) {
+                if (scroll) gb.bus.io[REG_SCX]++;
+                gb_run_frame(&gb);
+            }
+            double us = (double)(now_ns() - start) / frames / 1000.0;
+
+            u64 total = gb.ppu.line_cache_hits + gb.ppu.line_cache_misses;
+            double rate = total ? 100.0 * gb.ppu.line_cache_hits / total : 0.0;
+            printf("%-10s %-6s %14.2f %9.1f%%\n", scroll ? "scrolling" : "static",
+                   cache ? "on" : "off", us, rate);
+        }
+    }
+}
+
+// ------------------------------- scale ---------------------------------
+// Escalado de un frame real (la escena común) con cada filtro y backend
+
+static void bench_scale(void) {
+    const int iterations = 500;
+    static GameBoy gb;
+    static u32 rgba[FB_PIXELS];
+    static u32 out[FB_PIXELS * 16];
+    static u32 reference[FB_PIXELS * 16];
+
+    gb_init(&gb, NULL);
+    bench_scene(&gb);
+    gb_run_frame(&gb);
+    gb_run_frame(&gb);
+    const Frame* frame = fb_acquire(&gb.fb);
+
+    printf("%-8s %-8s %14s %12s\n", "filter", "backend", "us/frame", "frames/s");
+    for (int f = 0; f < SCALE_FILTER_COUNT; f++) {
+        int factor = scale_factor(f);
+        size_t size = (size_t)FB_PIXELS * factor * factor * sizeof(u32);
+        double scalar = 0;
+
+        for (int b = TILE_BACKEND_SCALAR; b <= TILE_BACKEND_SSE; b++) {
+            // Los nearest solo tienen versión escalar
+            if (b != TILE_BACKEND_SCALAR && f != SCALE_SCALE2X) continue;
+            if (!scale_set_backend(b)) continue;
+
+            u64 start = now_ns();
+            for (int it = 0; it < iterations; it++) {
+                scale_frame(f, frame, rgba, out);
+                bench_sink = (u8)out[it];
+            }
+            double us = (double)(now_ns() - start) / iterations / 1000.0;
+
+            if (b == TILE_BACKEND_SCALAR) {
+                memcpy(reference, out, size);
+                scalar = us;
+                printf("%-8s %-8s %14.2f %12.0f\n", scale_filter_name(f), tile_backend_name(b), us, 1e6 / us);
+            }
+            else {
+                bool same = memcmp(reference, out, size) == 0;
+                printf("%-8s %-8s %14.2f %12.0f   x%.1f%s\n", scale_filter_name(f), tile_backend_name(b),
+                       us, 1e6 / us, scalar / us, same ? "" : "  MISMATCH");
+            }
+        }
+    }
+
+    scale_set_backend(scale_init());
+}
+
+// ------------------------------- nosynth -------------------------------
+// La APU sin audio frente a una con audio: las mismas escrituras aleatorias
+// en los registros de sonido (y en DIV), con huecos aleatorios entre ellas.
+// Tras cada una se compara lo que el juego puede ver: NR52, los registros y
+// el estado de duración, envolvente, sweep y frame sequencer.
+
+static bool apu_visible_equal(GameBoy* a, GameBoy* b) {
+    for (u16 address = 0xFF10; address <= 0xFF26; address++) {
+        if (bus_read(a, address) != bus_read(b, address)) return false;
+    }
+
+    const Apu* x = &a->apu;
+    const Apu* y = &b->apu;
+    for (int c = 0; c < APU_CHANNELS; c++) {
+        const ApuChannel* p = &x->ch[c];
+        const ApuChannel* q = &y->ch[c];
+        if (p->enabled != q->enabled || p->dac != q->dac || p->length != q->length
+            || p->length_enable != q->length_enable || p->volume != q->volume
+            || p->env_period != q->env_period || p->env_up != q->env_up || p->env_timer != q->env_timer) {
+            return false;
+        }
+    }
+    return x->sweep_shadow == y->sweep_shadow && x->sweep_timer == y->sweep_timer
+        && x->sweep_enabled == y->sweep_enabled && x->next_seq == y->next_seq && x->seq_step == y->seq_step;
+}
+
+static void bench_nosynth(void) {
+    const int writes = 200000;
+    static GameBoy gb[2];
+
+    for (int i = 0; i < 2; i++) {
+        GbConfig config = { .no_audio = i == 1 };
+        gb_init(&gb[i], &config);
+    }
+
+    u32 rng = 0x12345678;
+    int mismatch = -1;
+    int done = 0;
+    u64 ns[2] = { 0, 0 };
+    for (int w = 0; w < writes && mismatch < 0; w++, done++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+
+        // Sobre todo NRxx; de vez en cuando DIV o apagar/encender (NR52)
+        u16 address = 0xFF10 + (rng >> 8) % 0x17;
+        if ((rng & 0xFF) == 0) address = 0xFF04;
+        u8 value = (u8)(rng >> 16);
+        if (address == 0xFF26) value = (rng & 0x100000) ? 0x80 : 0x00;
+        u32 gap = (rng >> 24) * 64;
+
+        for (int i = 0; i < 2; i++) {
+            u64 start = now_ns();
+            gb[i].ticks += gap;
+            sched_run(&gb[i]);
+            bus_write(&gb[i], address, value);
+            apu_sync(&gb[i]);
+            ns[i] += now_ns() - start;
+        }
+
+        if (!apu_visible_equal(&gb[0], &gb[1])) mismatch = w;
+    }
+
+    printf("%-8s %12s\n", "synth", "ns/escritura");
+    printf("%-8s %12.1f\n", "on", (double)ns[0] / done);
+    printf("%-8s %12.1f\n", "off", (double)ns[1] / done);
+    if (mismatch < 0) printf("%d escrituras: ok\n", writes);
+    else printf("%d escrituras: FALLO en la %d\n", writes, mismatch);
+}
+
+// ----------------------------- audioring -------------------------------
+// 1) Control de ritmo: un dispositivo simulado consume algo más rápido o más
+//    lento de lo nominal; el llenado debe estabilizarse sin huecos.
+// 2) Rendimiento del anillo con un productor y un consumidor en dos hilos.
+
+#define RING_BENCH_FRAMES (1 << 24)
+
+// Espera breve cuando el otro lado no ha avanzado (por si hay un solo núcleo)
+static void ring_wait(void) {
+    struct timespec ts = { 0, 1000 };
+    nanosleep(&ts, NULL);
+}
+
+static void* ring_consumer(void* arg) {
+    AudioRing* ring = arg;
+    i16 out[256 * 2];
+    u64 expected = 0;
+    u64 errors = 0;
+
+    while (expected < RING_BENCH_FRAMES) {
+        int n = audio_ring_read(ring, out, 256);
+        if (n == 0) ring_wait();
+        for (int i = 0; i < n; i++, expected++) {
+            if (out[i * 2] != (i16)(expected & 0x7FFF)) errors++;
+        }
+    }
+    return (void*)(uintptr_t)errors;
+}
+
+static void bench_audioring(void) {
+    static GameBoy gb;
+    static AudioRing ring;
+    const int frames = 3000;
+    const double nominal = (double)APU_DEFAULT_SAMPLE_RATE * FRAME_TICKS / APU_CLOCK_RATE;
+
+    printf("%-8s %10s %10s %10s %10s\n", "drift", "ratio", "fill", "underruns", "overruns");
+    const double drifts[] = { -0.003, 0.0, 0.003 };
+    for (int d = 0; d < 3; d++) {
+        gb_init(&gb, NULL);
+        bench_scene(&gb);
+        // Tono continuo en el canal 2
+        bus_write(&gb, 0xFF16, 0x80);
+        bus_write(&gb, 0xFF17, 0xF0);
+        bus_write(&gb, 0xFF18, 0xD6);
+        bus_write(&gb, 0xFF19, 0x86);
+
+        audio_ring_init(&ring, 2048);
+        static i16 device[4096 * 2];
+        double owed = 0;
+        bool started = false;
+        for (int f = 0; f < frames; f++) {
+            gb_run_frame(&gb);
+            audio_ring_pump(&ring, &gb);
+
+            // El dispositivo empieza cuando hay el objetivo en el anillo
+            if (!started && audio_ring_fill(&ring) < ring.target) continue;
+            started = true;
+            owed += nominal * (1.0 + drifts[d]);
+            int n = (int)owed;
+            owed -= n;
+            audio_ring_read(&ring, device, n);
+        }
+        double ratio = (double)gb.apu.left.factor / blip_factor(APU_CLOCK_RATE, gb.apu.sample_rate);
+        printf("%+7.1f%% %10.5f %10u %10llu %10llu\n", drifts[d] * 100, ratio,
+               audio_ring_fill(&ring), (unsigned long long)ring.underruns,
+               (unsigned long long)ring.overruns);
+    }
+
+    audio_ring_init(&ring, 0);
+    pthread_t consumer;
+    u64 start = now_ns();
+    pthread_create(&consumer, NULL, ring_consumer, &ring);
+
+    i16 chunk[256 * 2];
+    for (u64 sent = 0; sent < RING_BENCH_FRAMES;) {
+        int n = 0;
+        for (; n < 256; n++) {
+            chunk[n * 2] = chunk[n * 2 + 1] = (i16)((sent + n) & 0x7FFF);
+        }
+        // Reintenta lo que no cabe (aquí no se quiere perder nada)
+        int written = 0;
+        while (written < n) {
+            int w = audio_ring_write(&ring, &chunk[written * 2], n - written);
+            if (w == 0) ring_wait();
+            written += w;
+        }
+        sent += n;
+    }
+
+    void* errors;
+    pthread_join(consumer, &errors);
+    double ns = (double)(now_ns() - start) / RING_BENCH_FRAMES;
+    printf("spsc: %.2f ns/frame, %llu errores\n", ns, (unsigned long long)(uintptr_t)errors);
+}
+
+// ------------------------------- state ---------------------------------
+// Guardar y cargar un estado a mitad de frame, con cada backend. Se comprueba
+// que otra instancia que carga el estado llega al mismo frame, y que el hash
+// de memoria distingue un cambio del bit alto en dos palabras de una página.
+
+static void bench_state(void) {
+    const int iterations = 2000;
+    static GameBoy gb, copy;
+    static u8 buf[64 * 1024];
+
+    printf("%-8s %10s %12s %12s %8s\n", "backend", "bytes", "us/save", "us/load", "replay");
+    const PpuBackend backends[] = { PPU_BACKEND_FAST, PPU_BACKEND_FIFO };
+    for (int b = 0; b < 2; b++) {
+        GbConfig config = { .ppu_backend = backends[b] };
+        gb_init(&gb, &config);
+        bench_scene(&gb);
+        bus_write(&gb, 0xFF16, 0x80);
+        bus_write(&gb, 0xFF17, 0xF0);
+        bus_write(&gb, 0xFF19, 0x86);
+        gb_run_frame(&gb);
+        u64 half = gb.ticks + FRAME_TICKS / 2;
+        while (gb.ticks < half) gb_step(&gb);
+
+        size_t size = gb_save_state(&gb, buf, sizeof(buf));
+        u64 start = now_ns();
+        for (int it = 0; it < iterations; it++) gb_save_state(&gb, buf, sizeof(buf));
+        double save_us = (double)(now_ns() - start) / iterations / 1000.0;
+
+        gb_init(&copy, &config);
+        start = now_ns();
+        for (int it = 0; it < iterations; it++) gb_load_state(&copy, buf, size);
+        double load_us = (double)(now_ns() - start) / iterations / 1000.0;
+
+        // Las dos instancias tienen que seguir igual
+        for (int f = 0; f < 3; f++) {
+            gb_run_frame(&gb);
+            gb_run_frame(&copy);
+        }
+        bool same = gb.ticks == copy.ticks && gb.cpu.pc == copy.cpu.pc
+                 && memcmp(&gb.fb.frames[gb.fb.last].pixels, &copy.fb.frames[copy.fb.last].pixels, FB_FRAME_BYTES) == 0
+                 && memcmp(gb.bus.wram, copy.bus.wram, WRAM_SIZE) == 0;
+
+        printf("%-8s %10zu %12.2f %12.2f %8s\n", b ? "fifo" : "fast", size, save_us, load_us,
+               same ? "ok" : "FALLO");
+    }
+
+    MemoryHash mh;
+    memory_hash_init(&mh);
+    u64 before = gb_memory_hash(&gb, &mh, NULL);
+    gb.bus.wram[0x107] ^= 0x80;
+    gb.bus.wram[0x10F] ^= 0x80;
+    memory_hash_init(&mh);
+    u64 after = gb_memory_hash(&gb, &mh, NULL);
+    printf("hash: %s\n", before != after ? "ok" : "FALLO");
+}
+
+// ------------------------------- rewind --------------------------------
+// 10 s de rebobinado (600 frames). Cada frame el "juego" cambia unos cientos
+// de bytes de WRAM y algo de OAM; se mide la memoria por segundo, el coste
+// de guardar y el de volver atrás, y se comprueba que se vuelve al estado
+// exacto de cada frame.
+
+static void bench_rewind(void) {
+    const u32 seconds = 10;
+    const u32 frames = seconds * 60;
+    static GameBoy gb;
+    static u8 expected[64 * 1024];
+    static u8 actual[64 * 1024];
+    Rewind rw;
+
+    gb_init(&gb, NULL);
+    bench_scene(&gb);
+    if (!rewind_init(&rw, &gb, frames, 0)) return;
+
+    u64 push_ns = 0;
+    size_t checkpoint = 0;
+    for (u32 f = 0; f < frames + 1; f++) {
+        for (int i = 0; i < 256; i++) bus_write(&gb, 0xC100 + (rand() % 2048), rand());
+        for (int i = 0; i < 8; i++) bus_write(&gb, 0xFE00 + (rand() % OAM_SIZE), rand());
+        gb_run_frame(&gb);
+
+        // Estado de referencia a mitad del recorrido
+        if (f == frames / 2) checkpoint = gb_save_state(&gb, expected, sizeof(expected));
+
+        u64 start = now_ns();
+        rewind_push(&rw, &gb);
+        push_ns += now_ns() - start;
+    }
+
+    size_t full = rw.state_size * frames;
+    printf("estado: %zu bytes, %u frames guardados\n", rw.state_size, rewind_available(&rw));
+    printf("memoria: %.1f KB/s (%.1f%% de estados completos, anillo de %zu KB)\n",
+           (double)rw.used / seconds / 1024.0, 100.0 * rw.used / full, rw.data_size / 1024);
+    printf("guardar: %.2f us/frame\n", (double)push_ns / (frames + 1) / 1000.0);
+
+    u32 steps = frames - frames / 2;
+    u64 start = now_ns();
+    for (u32 s = 0; s < steps; s++) rewind_step_back(&rw, &gb);
+    double back_us = (double)(now_ns() - start) / steps / 1000.0;
+
+    size_t size = gb_save_state(&gb, actual, sizeof(actual));
+    bool same = size == checkpoint && memcmp(expected, actual, size) == 0;
+    printf("atrás: %.2f us/frame, estado %s\n", back_us, same ? "ok" : "FALLO");
+    rewind_free(&rw);
+}
+
+// -------------------------------- fork ---------------------------------
+// Forks por segundo desde una instancia en marcha (sin audio, sin dibujar,
+// como en una búsqueda), solos y seguidos de unos frames. Se comprueba que
+// un hijo sigue exactamente el mismo camino que el padre.
+
+static void bench_fork(void) {
+    const int forks = 20000;
+    static GameBoy parent;
+    static GameBoy children[8];
+    static u8 expected[64 * 1024];
+    static u8 actual[64 * 1024];
+
+    GbConfig config = { .no_audio = true };
+    gb_init(&parent, &config);
+    bench_scene(&parent);
+    ppu_set_render_policy(&parent, PPU_RENDER_NEVER, 0);
+    gb_run_frame(&parent);
+    for (int c = 0; c < 8; c++) gb_init(&children[c], NULL);
+
+    printf("%-14s %12s %12s\n", "frames/fork", "us/fork", "forks/s");
+    const int runs[] = { 0, 1, 4 };
+    for (int r = 0; r < 3; r++) {
+        u64 start = now_ns();
+        for (int i = 0; i < forks; i++) {
+            GameBoy* child = &children[i & 7];
+            gb_fork_into(child, &parent);
+            for (int f = 0; f < runs[r]; f++) gb_run_frame(child);
+        }
+        double us = (double)(now_ns() - start) / forks / 1000.0;
+        printf("%-14d %12.2f %12.0f\n", runs[r], us, 1e6 / us);
+    }
+
+    gb_fork_into(&children[0], &parent);
+    for (int f = 0; f < 10; f++) {
+        gb_run_frame(&parent);
+        gb_run_frame(&children[0]);
+    }
+    size_t size = gb_save_state(&parent, expected, sizeof(expected));
+    bool same = size == gb_save_state(&children[0], actual, sizeof(actual))
+             && memcmp(expected, actual, size) == 0;
+    printf("hijo tras 10 frames: %s\n", same ? "ok" : "FALLO");
+}
+
+// ------------------------------- movie ---------------------------------
+// Graba 3000 frames de entrada aleatoria sobre un programa que acumula lo
+// que lee del joypad, y compara ir al frame 2900 con la búsqueda por
+// keyframes frente a reproducir desde el principio.
+
+static void bench_movie(void) {
+    const u64 frames = 3000;
+    const u64 target = 2900;
+    static GameBoy gb;
+    static u8 expected[64 * 1024];
+    static u8 actual[64 * 1024];
+    Movie movie;
+
+    gb_init(&gb, NULL);
+    bench_scene(&gb);
+    // $C000: LD A,$20; LDH ($00),A; LDH A,($00); LD HL,$C100; ADD (HL);
+    //        LD (HL),A; JR $C000
+    static const u8 program[] = {
+        0x3E, 0x20, 0xE0, 0x00, 0xF0, 0x00, 0x21, 0x00, 0xC1, 0x86, 0x77, 0x18, 0xF3,
+    };
+    for (int i = 0; i < (int)sizeof(program); i++) bus_write(&gb, 0xC000 + i, program[i]);
+
+    movie_init(&movie, 0);
+    movie_record_start(&movie, &gb);
+    u8 buttons = 0;
+    size_t size = 0;
+    for (u64 f = 0; f < frames; f++) {
+        if (f == target) size = gb_save_state(&gb, expected, sizeof(expected));
+        if (rand() % 20 == 0) buttons = rand();
+        movie_record_frame(&movie, &gb, buttons);
+    }
+
+    printf("%-12s %12s %8s\n", "modo", "ms", "estado");
+    for (int replay = 0; replay < 2; replay++) {
+        gb_init(&gb, NULL);
+        u64 start = now_ns();
+        if (replay) {
+            movie_seek(&movie, &gb, 0);
+            while (movie.position < target) movie_play_frame(&movie, &gb);
+        }
+        else {
+            movie_seek(&movie, &gb, target);
+        }
+        double ms = (double)(now_ns() - start) / 1e6;
+
+        bool same = gb_save_state(&gb, actual, sizeof(actual)) == size
+                 && memcmp(expected, actual, size) == 0;
+        printf("%-12s %12.2f %8s\n", replay ? "reproducir" : "keyframes", ms, same ? "ok" : "FALLO");
+    }
+    movie_free(&movie);
+}
+
+// ------------------------------ runahead -------------------------------
+// Coste por frame de adelantar K frames, y comprobación de que lo que se
+// publica tras el frame n es el frame n + K de una ejecución normal (con la
+// misma entrada siempre). El programa cambia el mapa de tiles sin parar.
+
+static void runahead_scene(GameBoy* gb) {
+    bench_scene(gb);
+    // $C000: LD HL,$9800; INC (HL); INC L; JR $C003
+    static const u8 program[] = { 0x21, 0x00, 0x98, 0x34, 0x2C, 0x18, 0xFC };
+    for (int i = 0; i < (int)sizeof(program); i++) bus_write(gb, 0xC000 + i, program[i]);
+}
+
+static void bench_runahead(void) {
+    enum { CHECK_FRAMES = 60, TIMED_FRAMES = 600 };
+    static GameBoy gb;
+    static u8 reference[CHECK_FRAMES + RUNAHEAD_MAX_FRAMES][FB_FRAME_BYTES];
+    const u8 buttons = JOYPAD_RIGHT | JOYPAD_A;
+
+    gb_init(&gb, NULL);
+    runahead_scene(&gb);
+    joypad_set(&gb, buttons);
+    for (int f = 0; f < CHECK_FRAMES + RUNAHEAD_MAX_FRAMES; f++) {
+        gb_run_frame(&gb);
+        memcpy(reference[f], gb.fb.frames[gb.fb.last].pixels, FB_FRAME_BYTES);
+    }
+
+    printf("%-4s %12s %12s %8s\n", "K", "us/frame", "extra us", "imagen");
+    for (u32 k = 0; k <= 4; k++) {
+        RunAhead ra;
+        gb_init(&gb, NULL);
+        runahead_scene(&gb);
+        runahead_init(&ra, &gb, k);
+
+        bool same = true;
+        for (int f = 0; f < CHECK_FRAMES; f++) {
+            runahead_frame(&ra, &gb, buttons);
+            same = same && memcmp(reference[f + k], gb.fb.frames[gb.fb.last].pixels, FB_FRAME_BYTES) == 0;
+        }
+
+        ra.extra_ns = ra.frames_run = 0;
+        u64 start = now_ns();
+        for (int f = 0; f < TIMED_FRAMES; f++) runahead_frame(&ra, &gb, buttons);
+        double us = (double)(now_ns() - start) / TIMED_FRAMES / 1000.0;
+        printf("%-4u %12.2f %12.2f %8s\n", k, us, runahead_extra_us(&ra), same ? "ok" : "FALLO");
+        runahead_free(&ra);
+    }
+}
+
+// ------------------------------ rollback -------------------------------
+// Dos extremos por loopback, cada uno con las dos consolas, y entrada
+// aleatoria en cada frame: la predicción falla siempre y cada frame hay que
+// volver atrás tantos frames como el retardo. Se mide el rollback más lento
+// frente a la duración de un frame real (16.74 ms), marcando si no cabe, y
+// al final las cuatro consolas tienen que estar como las de una partida sin
+// red.
+
+#define BENCH_FRAME_NS 16742706ULL
+
+static void rollback_scene(GameBoy* gb) {
+    GbConfig config = { .no_audio = true };
+    gb_init(gb, &config);
+    bench_scene(gb);
+    // El programa de bench_movie: acumula lo que lee del joypad
+    static const u8 program[] = {
+        0x3E, 0x20, 0xE0, 0x00, 0xF0, 0x00, 0x21, 0x00, 0xC1, 0x86, 0x77, 0x18, 0xF3,
+    };
+    for (int i = 0; i < (int)sizeof(program); i++) bus_write(gb, 0xC000 + i, program[i]);
+}
+
+static void bench_rollback(void) {
+    enum { FRAMES = 600 };
+    static GameBoy peers[2][2]; // [extremo][consola]
+    static u8 inputs[2][FRAMES];
+    static u8 expected[2][64 * 1024];
+    static u8 actual[64 * 1024];
+    size_t size[2];
+
+    srand(7);
+    for (int p = 0; p < 2; p++) {
+        for (int f = 0; f < FRAMES; f++) inputs[p][f] = rand();
+    }
+    for (int p = 0; p < 2; p++) {
+        rollback_scene(&peers[0][p]);
+        for (int f = 0; f < FRAMES; f++) {
+            joypad_set(&peers[0][p], inputs[p][f]);
+            gb_run_frame(&peers[0][p]);
+        }
+        size[p] = gb_save_state(&peers[0][p], expected[p], sizeof(expected[p]));
+    }
+
+    printf("%-4s %10s %10s %10s %10s %6s %8s %8s %8s\n", "N", "us/frame", "medio us", "peor us", "% frame",
+           "cabe", "frames", "paradas", "estado");
+    const u32 windows[] = { 2, 4, ROLLBACK_MAX_FRAMES };
+    for (int w = 0; w < 3; w++) {
+        u32 n = windows[w];
+        static LoopbackLink link;
+        Rollback rb[2];
+        loopback_init(&link, n);
+        for (int e = 0; e < 2; e++) {
+            rollback_scene(&peers[e][0]);
+            rollback_scene(&peers[e][1]);
+            rollback_init(&rb[e], &peers[e][0], &peers[e][1], e, n, loopback_transport(&link, e));
+        }
+
+        u64 busy = 0;
+        u64 calls = 0;
+        for (int h = 0; h < 4 * FRAMES && (rb[0].frame < FRAMES || rb[1].frame < FRAMES); h++) {
+            loopback_tick(&link);
+            for (int e = 0; e < 2; e++) {
+                if (rb[e].frame == FRAMES) continue;
+                u64 start = now_ns();
+                rollback_frame(&rb[e], inputs[e][rb[e].frame]);
+                busy += now_ns() - start;
+                calls++;
+            }
+        }
+        for (int h = 0; h < 4 * (int)n && !(rollback_synced(&rb[0]) && rollback_synced(&rb[1])); h++) {
+            loopback_tick(&link);
+            rollback_update(&rb[0]);
+            rollback_update(&rb[1]);
+        }
+
+        bool same = true;
+        for (int e = 0; e < 2; e++) {
+            for (int p = 0; p < 2; p++) {
+                same = same && gb_save_state(&peers[e][p], actual, sizeof(actual)) == size[p]
+                            && memcmp(expected[p], actual, size[p]) == 0;
+            }
+        }
+
+        u64 worst = rb[0].max_rollback_ns > rb[1].max_rollback_ns ? rb[0].max_rollback_ns : rb[1].max_rollback_ns;
+        u32 frames = rb[0].max_resimulated > rb[1].max_resimulated ? rb[0].max_resimulated : rb[1].max_resimulated;
+        double average = (double)(rb[0].rollback_ns + rb[1].rollback_ns) / (rb[0].rollbacks + rb[1].rollbacks);
+        printf("%-4u %10.1f %10.1f %10.1f %9.1f%% %6s %8u %8llu %8s\n", n, (double)busy / calls / 1000.0,
+               average / 1000.0, worst / 1000.0, 100.0 * worst / BENCH_FRAME_NS,
+               worst < BENCH_FRAME_NS ? "ok" : "NO", frames,
+               (unsigned long long)(rb[0].stalls + rb[1].stalls), same ? "ok" : "FALLO");
+        rollback_free(&rb[0]);
+        rollback_free(&rb[1]);
+    }
+}
+
+// -------------------------------- link ---------------------------------
+// Dos consolas por cable: lo que cuesta el cable sin transferencias (frente
+// a dos instancias sueltas) y con una transferencia detrás de otra. La que
+// manda envía 0, 1, 2...; la otra guarda lo que recibe y contesta con su
+// complemento.
+
+static void link_scene(GameBoy* gb, bool master) {
+    static const u8 master_program[] = {
+        0x21, 0x00, 0xD0,   // LD HL,$D000
+        0x0E, 0x00,         // LD C,$00
+        0x79,               // LD A,C
+        0xE0, 0x01,         // LDH ($01),A
+        0x3E, 0x81,         // LD A,$81
+        0xE0, 0x02,         // LDH ($02),A
+        0xF0, 0x02,         // LDH A,($02)
+        0xCB, 0x7F,         // BIT 7,A
+        0x20, 0xFA,         // JR NZ,-6
+        0xF0, 0x01,         // LDH A,($01)
+        0x77, 0x2C, 0x0C,   // LD (HL),A; INC L; INC C
+        0x18, 0xEC,         // JR $C005
+    };
+    static const u8 slave_program[] = {
+        0x21, 0x00, 0xD0,   // LD HL,$D000
+        0x3E, 0x80,         // LD A,$80
+        0xE0, 0x02,         // LDH ($02),A
+        0xF0, 0x02,         // LDH A,($02)
+        0xCB, 0x7F,         // BIT 7,A
+        0x20, 0xFA,         // JR NZ,-6
+        0xF0, 0x01,         // LDH A,($01)
+        0x77, 0x2C, 0x2F,   // LD (HL),A; INC L; CPL
+        0xE0, 0x01,         // LDH ($01),A
+        0x18, 0xED,         // JR $C003
+    };
+    GbConfig config = { .no_audio = true };
+    gb_init(gb, &config);
+    bench_scene(gb);
+    const u8* program = master ? master_program : slave_program;
+    int size = master ? (int)sizeof(master_program) : (int)sizeof(slave_program);
+    for (int i = 0; i < size; i++) bus_write(gb, 0xC000 + i, program[i]);
+}
+
+static void bench_link(void) {
+    const int frames = 600;
+    static GameBoy a, b;
+
+    printf("%-16s %12s %8s\n", "modo", "us/frame", "datos");
+    for (int mode = 0; mode < 3; mode++) {
+        // 0: sueltas, 1: cable sin transferencias, 2: transfiriendo
+        if (mode < 2) {
+            gb_init(&a, NULL);
+            gb_init(&b, NULL);
+            bench_scene(&a);
+            bench_scene(&b);
+        }
+        else {
+            link_scene(&a, true);
+            link_scene(&b, false);
+        }
+        if (mode > 0) serial_connect(&a, &b);
+
+        u64 start = now_ns();
+        for (int f = 0; f < frames; f++) {
+            if (mode == 0) {
+                gb_run_frame(&a);
+                gb_run_frame(&b);
+            }
+            else {
+                serial_run_frame(&a);
+            }
+        }
+        double us = (double)(now_ns() - start) / frames / 1000.0;
+
+        // Lo último que ha recibido cada una (las 256 últimas transferencias)
+        const char* data = "-";
+        u8 sent = a.cpu.c;
+        if (mode == 2) {
+            bool ok = sent == b.cpu.l && BIT(a.cpu.if_reg, 3) && BIT(b.cpu.if_reg, 3);
+            for (int k = 1; k <= 255; k++) {
+                u8 n = (u8)(sent - k);
+                u8 reply = n ^ 0xFF;
+                ok = ok && b.bus.wram[0x1000 + n] == n
+                        && a.bus.wram[0x1000 + (u8)(n + 1)] == reply;
+            }
+            data = ok ? "ok" : "FALLO";
+        }
+        static const char* names[] = { "sueltas", "cable parado", "transfiriendo" };
+        printf("%-16s %12.2f %8s\n", names[mode], us, data);
+        serial_disconnect(&a);
+    }
+}
+
+// Lockstep: las dos esperan cada transferencia en HALT (IE solo serie, sin
+// IME), así que despiertan en el instante en que se levanta IF, y después
+// recorren una ristra de NOPs: el PC dice desde cuándo, al ciclo. La que
+// contesta vuelve a esperar cuando la otra ya ha empezado a mandar (el caso
+// en que la que espera va por delante). Al final de cada frame de la que
+// guía, las dos tienen que estar igual que avanzando las dos instrucción a
+// instrucción hasta el mismo punto.
+
+#define LOCKSTEP_MASTER_NOPS 2000 // 8000 ticks
+#define LOCKSTEP_SLAVE_NOPS  2500 // 10000: vuelve a esperar 2000 ticks tarde
+
+static void lockstep_scene(GameBoy* gb, bool master) {
+    static const u8 master_program[] = {
+        0x3E, 0x08,         // LD A,$08
+        0xE0, 0xFF,         // LDH ($FF),A (IE: solo serie)
+        0x0E, 0x00,         // LD C,$00
+        0xAF,               // $C006: XOR A
+        0xE0, 0x0F,         // LDH ($0F),A
+        0x0C, 0x79,         // INC C; LD A,C
+        0xE0, 0x01,         // LDH ($01),A
+        0x3E, 0x81,         // LD A,$81
+        0xE0, 0x02,         // LDH ($02),A
+        0x76,               // HALT
+    };
+    static const u8 slave_program[] = {
+        0x3E, 0x08,         // LD A,$08
+        0xE0, 0xFF,         // LDH ($FF),A
+        0x0E, 0x00,         // LD C,$00 (como la otra)
+        0xAF,               // $C006: XOR A
+        0xE0, 0x0F,         // LDH ($0F),A
+        0xF0, 0x01, 0x2F,   // LDH A,($01); CPL
+        0xE0, 0x01,         // LDH ($01),A
+        0x3E, 0x80,         // LD A,$80
+        0xE0, 0x02,         // LDH ($02),A
+        0x76,               // HALT
+    };
+    GbConfig config = { .no_audio = true };
+    gb_init(gb, &config);
+    const u8* program = master ? master_program : slave_program;
+    int size = master ? (int)sizeof(master_program) : (int)sizeof(slave_program);
+    int nops = master ? LOCKSTEP_MASTER_NOPS : LOCKSTEP_SLAVE_NOPS;
+    for (int i = 0; i < size; i++) gb->bus.wram[i] = program[i];
+    for (int i = 0; i < nops; i++) gb->bus.wram[size + i] = 0x00;
+    gb->bus.wram[size + nops] = 0xC3; // JP $C006
+    gb->bus.wram[size + nops + 1] = 0x06;
+    gb->bus.wram[size + nops + 2] = 0xC0;
+    gb->cpu.pc = 0xC000;
+}
+
+// Avanza las dos instrucción a instrucción, siempre la que va por detrás
+// (con el mismo instante, first), hasta que gb[x] llega a end y la otra
+// también
+static void lockstep_to(GameBoy gb[2], int x, u64 end, int first) {
+    GameBoy* lead = &gb[x];
+    GameBoy* other = &gb[x ^ 1];
+    for (;;) {
+        u64 t = other->ticks + other->serial.offset; // Reloj de la otra en el de lead
+        bool lead_done = lead->ticks >= end;
+        bool other_done = t >= end;
+        if (lead_done && other_done) break;
+
+        bool step_lead = !lead_done && (other_done || lead->ticks < t || (lead->ticks == t && first == x));
+        gb_step(step_lead ? lead : other);
+    }
+}
+
+static bool lockstep_equal(const GameBoy* x, const GameBoy* y) {
+    static u8 state_x[64 * 1024];
+    static u8 state_y[64 * 1024];
+    size_t size = gb_save_state(x, state_x, sizeof(state_x));
+    return gb_save_state(y, state_y, sizeof(state_y)) == size && memcmp(state_x, state_y, size) == 0;
+}
+
+static void bench_lockstep(void) {
+    const int frames = 300;
+    static GameBoy ref[2], run[2];
+
+    printf("%-24s %8s %14s %8s\n", "ejecución", "frames", "transferencias", "estado");
+    static const char* names[] = { "paso a paso (b primero)", "guía a", "guía b" };
+    for (int mode = 0; mode < 3; mode++) {
+        for (int p = 0; p < 2; p++) {
+            lockstep_scene(&ref[p], p == 0);
+            lockstep_scene(&run[p], p == 0);
+        }
+        serial_connect(&ref[0], &ref[1]);
+        serial_connect(&run[0], &run[1]);
+
+        // La referencia, con a primero en los empates, hasta donde ha
+        // quedado la que guía
+        int x = mode == 2 ? 1 : 0;
+        int f = 0;
+        u32 transfers = 0;
+        u8 count = 0; // C de la que manda: una por transferencia
+        for (; f < frames; f++) {
+            if (mode == 0) lockstep_to(run, 0, run[0].ticks + FRAME_TICKS, 1);
+            else serial_run_frame(&run[x]);
+            lockstep_to(ref, x, run[x].ticks, 0);
+            if (!lockstep_equal(&ref[0], &run[0]) || !lockstep_equal(&ref[1], &run[1])) break;
+            transfers += (u8)(run[0].cpu.c - count);
+            count = run[0].cpu.c;
+        }
+        printf("%-24s %8d %14u %8s\n", names[mode], f, transfers, f == frames ? "ok" : "FALLO");
+        serial_disconnect(&ref[0]);
+        serial_disconnect(&run[0]);
+    }
+}
+
+// -------------------------------- pool ---------------------------------
+// Escalado del pool con robo de trabajo: las mismas instancias (el doble que
+// núcleos, de duración desigual) con 1, 2, 4... hilos hasta el número de
+// núcleos, de 30 en 30 frames como gameboy-emu batch.
+
+typedef struct {
+    GameBoy gb;
+    u32 frames;
+    u32 done;
+} PoolBenchJob;
+
+static bool pool_bench_slice(void* arg, int worker) {
+    (void)worker;
+    PoolBenchJob* job = arg;
+    for (int f = 0; f < 30 && job->done < job->frames; f++, job->done++) gb_run_frame(&job->gb);
+    return job->done < job->frames;
+}
+
+static void bench_pool(void) {
+    int cores = pool_cpu_count();
+    int count = 2 * cores;
+    PoolBenchJob* jobs = malloc(sizeof(PoolBenchJob) * count);
+    if (!jobs) return;
+
+    printf("%d núcleos\n%-8s %12s %10s %8s\n", cores, "hilos", "frames/s", "speedup", "robos");
+    double base = 0;
+    for (int threads = 1; ; threads *= 2) {
+        if (threads > cores) threads = cores;
+
+        WorkPool* pool = pool_create(threads, count);
+        u64 frames = 0;
+        for (int i = 0; i < count; i++) {
+            GbConfig config = { .no_audio = true };
+            gb_init(&jobs[i].gb, &config);
+            bench_scene(&jobs[i].gb);
+            ppu_set_render_policy(&jobs[i].gb, PPU_RENDER_NEVER, 0);
+            jobs[i].frames = 120 + 60 * (i % 4);
+            jobs[i].done = 0;
+            frames += jobs[i].frames;
+            pool_submit(pool, pool_bench_slice, &jobs[i]);
+        }
+
+        u64 start = now_ns();
+        pool_run(pool);
+        double rate = frames / ((double)(now_ns() - start) / 1e9);
+        if (threads == 1) base = rate;
+        printf("%-8d %12.0f %9.2fx %8llu\n", threads, rate, rate / base, (unsigned long long)pool_steals(pool));
+        pool_destroy(pool);
+
+        if (threads == cores) break;
+    }
+    free(jobs);
+}
+
+// ------------------------------ romcache -------------------------------
+// Carga 256 veces una ROM de 1MB (MBC5 con RAM) desde dos ficheros con el
+// mismo contenido y una vez desde uno distinto: tiempo por carga y cuántas
+// imágenes quedan en memoria.
+
+static bool write_rom(char* path, u8 variant) {
+    static u8 rom[1024 * 1024];
+    for (size_t i = 0; i < sizeof(rom); i++) rom[i] = (u8)(i * 31 + (i >> 14) + variant);
+    rom[0x0147] = 0x1B; // MBC5 + RAM + batería
+    rom[0x0149] = 0x03; // 32KB
+
+    int fd = mkstemp(path);
+    if (fd < 0) return false;
+    bool ok = write(fd, rom, sizeof(rom)) == (ssize_t)sizeof(rom);
+    close(fd);
+    return ok;
+}
+
+static void bench_romcache(void) {
+    enum { CARTS = 256 };
+    static Cart carts[CARTS];
+    static Cart other;
+    char paths[3][32] = { "/tmp/gb-romXXXXXX", "/tmp/gb-romXXXXXX", "/tmp/gb-romXXXXXX" };
+    if (!write_rom(paths[0], 0) || !write_rom(paths[1], 0) || !write_rom(paths[2], 1)) {
+        printf("no se pueden escribir las ROM de prueba\n");
+        return;
+    }
+
+    u64 start = now_ns();
+    bool ok = true;
+    for (int i = 0; i < CARTS; i++) ok &= cart_load(&carts[i], paths[i & 1]);
+    double us = (double)(now_ns() - start) / CARTS / 1000.0;
+    ok &= cart_load(&other, paths[2]);
+
+    // Mismo contenido: misma imagen; los registros y la RAM son de cada uno
+    for (int i = 1; ok && i < CARTS; i++) ok = carts[i].rom == carts[0].rom;
+    ok = ok && other.rom != carts[0].rom;
+    cart_write(&carts[1], 0x0000, 0x0A);
+    cart_write(&carts[1], 0x2000, 5);
+    cart_write_ram(&carts[1], 0xA000, 0x42);
+    ok = ok && cart_read(&carts[1], 0x4000) == carts[0].rom[5 * ROM_BANK_SIZE]
+            && cart_read(&carts[0], 0x4000) == carts[0].rom[ROM_BANK_SIZE]
+            && cart_ram_bank(&carts[0], 0)[0] == 0;
+    int images = cart_cached_images();
+
+    for (int i = 0; i < CARTS; i++) cart_free(&carts[i]);
+    cart_free(&other);
+    for (int i = 0; i < 3; i++) remove(paths[i]);
+
+    printf("%d cartuchos: %.1f us/carga, %d imágenes (%d KB en vez de %d KB)\n", CARTS + 1, us, images,
+           images * 1024, (CARTS + 1) * 1024);
+    printf("compartido: %s, liberado: %s\n", ok ? "ok" : "FALLO", cart_cached_images() == 0 ? "ok" : "FALLO");
+}
+
+// ----------------------------------------------------------------------
+
+typedef struct {
+    const char* name;
+    void (*run)(void);
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+    { "tiles", bench_tiles },
+    { "frames", bench_frames },
+    { "linecache", bench_linecache },
+    { "scale", bench_scale },
+    { "nosynth", bench_nosynth },
+    { "audioring", bench_audioring },
+    { "state", bench_state },
+    { "rewind", bench_rewind },
+    { "fork", bench_fork },
+    { "movie", bench_movie },
+    { "runahead", bench_runahead },
+    { "rollback", bench_rollback },
+    { "link", bench_link },
+    { "lockstep", bench_lockstep },
+    { "pool", bench_pool },
+    { "romcache", bench_romcache },
+};
+
+#define BENCH_COUNT ((int)(sizeof(benchmarks) / sizeof(benchmarks[0])))
+
+int bench_main(int argc, char** argv) {
+    for (int i = 0; i < BENCH_COUNT; i++) {
+        // Sin argumentos se ejecutan todos
+        bool selected = (argc == 0);
+        for (int a = 0; a < argc; a++) {
+            if (strcmp(argv[a], benchmarks[i].name) == 0) selected = true;
+        }
+        if (!selected) continue;
+
+        printf("--- BENCH: %s ---\n", benchmarks[i].name);
+        benchmarks[i].run();
+    }
+    return 0;
+}
@@ -2,16 +2,22 @@
 #include "gb.h"
 
 u8 bus_read(GameBoy* gb, u16 address) {
-    // 1. MODO TEST
-    if (gb->bus.test_mode) {
-        return gb->bus.flat_memory[address];
+    // 1. MODOS ESPECIALES (una sola comprobación en la ruta común)
+    if (gb->bus.access_mode) {
+        // MODO TEST
+        if (gb->bus.access_mode & BUS_MODE_TEST) {
+            return gb->bus.flat_memory[address];
+        }
+        // DMA en curso: fuera de I/O, HRAM e IE el bus devuelve basura
+        if (address < 0xFF00) {
+            return 0xFF;
+        }
     }
     
     // 2. MODO PRODUCCIÓN
     // ROM (Cartucho)
     if (address < 0x8000) {
-        return 0; // TODO: Cartucho
-        //return cart_read(gb->cart, address);
+        return cart_read(&gb->cart, address);
     }
 
     // VRAM (Video)
@@ -21,8 +27,7 @@ u8 bus_read(GameBoy* gb, u16 address) {
 
     // External RAM (Cartucho)
     else if (address < 0xC000) {
-        return 0; // TODO: Cartucho
-        //return cart_read(gb->cart, address);
+        return cart_read_ram(&gb->cart, address);
     }
 
     // WRAM (Working RAM)
@@ -36,7 +41,6 @@ u8 bus_read(GameBoy* gb, u16 address) {
     }
     // OAM (Sprites)
     else if (address < 0xFEA0) {
-        // TODO: Bloquear si la PPU está leyendo (DMA)
         return gb->bus.oam[address - 0xFE00];
     }
 
@@ -52,9 +56,29 @@ u8 bus_read(GameBoy* gb, u16 address) {
         return gb->cpu.if_reg | 0xE0;
     }
 
+    // Joypad: depende de los botones y del grupo seleccionado
+    else if (address == REG_P1_ADDR) {
+        return joypad_read(gb);
+    }
+
+    // Puerto serie
+    else if (address == REG_SB_ADDR || address == REG_SC_ADDR) {
+        return serial_read(gb, address);
+    }
+
+    // Timer: se calcula en el momento de la lectura
+    else if (address >= REG_DIV_ADDR && address <= REG_TAC_ADDR) {
+        return timer_read(gb, address);
+    }
+
+    // Sonido y Wave RAM
+    else if (address >= 0xFF10 && address < 0xFF40) {
+        return apu_read(gb, address);
+    }
+
     // I/O Registers
     else if (address >= 0xFF00 && address < 0xFF80) {
-        // Aquí manejamos joypad, timers, audio...
+        // Aquí manejamos joypad...
         return gb->bus.io[address - 0xFF00];
     }
 
@@ -79,26 +103,38 @@ u16 bus_read16(GameBoy* gb, u16 addr) {
 }
 
 void bus_write(GameBoy* gb, u16 address, u8 value) {
-    // 1. MODO TEST (Usamos flat_memory)
-    if (gb->bus.test_mode) {
-        // Escribimos siempre en la memoria plana (para que el JSON verify funcione)
-        gb->bus.flat_memory[address] = value;
-
-        return; // Salimos, no hacemos nada más
+    // 1. MODOS ESPECIALES (una sola comprobación en la ruta común)
+    if (gb->bus.access_mode) {
+        // MODO TEST (Usamos flat_memory)
+        if (gb->bus.access_mode & BUS_MODE_TEST) {
+            // Escribimos siempre en la memoria plana (para que el JSON verify funcione)
+            gb->bus.flat_memory[address] = value;
+
+            return; // Salimos, no hacemos nada más
+        }
+        // DMA en curso: fuera de I/O, HRAM e IE las escrituras se pierden
+        // (los registros siguen accesibles; $FF46 puede relanzar la DMA)
+        if (address < 0xFF00) {
+            return;
+        }
     }
 
     // 2. MODO PRODUCCIÓN
+    bus_mark_dirty(&gb->bus, address);
+
     if (address < 0x8000) {
         // ¡IMPORTANTE! Escribir en ROM configura el MBC (Banking)
-        // TODO: Cartucho
-        // cart_write(gb->cart, address, value);
+        cart_write(&gb->cart, address, value);
     }
     else if (address < 0xA000) {
         gb->bus.vram[address - 0x8000] = value;
+        // Los datos de tiles invalidan su entrada en la caché de la PPU
+        if (address < TILE_DATA_END) {
+            ppu_invalidate_tile(&gb->ppu, address - 0x8000);
+        }
     }
     else if (address < 0xC000) {
-        // TODO: Cartucho
-        // cart_write(gb->cart, address, value);
+        cart_write_ram(&gb->cart, address, value);
     }
     else if (address < 0xE000) {
         gb->bus.wram[address - 0xC000] = value;
@@ -109,6 +145,7 @@ void bus_write(GameBoy* gb, u16 address, u8 value) {
     }
     else if (address < 0xFEA0) {
         gb->bus.oam[address - 0xFE00] = value;
+        ppu_invalidate_sprite(&gb->ppu, address - 0xFE00);
     }
     // Not Usable
     else if (address < 0xFF00) {
@@ -119,11 +156,54 @@ void bus_write(GameBoy* gb, u16 address, u8 value) {
         // Escritura en IF (El juego puede querer limpiar una interrupción manualmente)
         gb->cpu.if_reg = value | 0xE0; // Bits 
     }
+    // Sonido y Wave RAM
+    else if (address >= 0xFF10 && address < 0xFF40) {
+        apu_write(gb, address, value);
+    }
     // I/O Registers
     else if (address >= 0xFF00 && address < 0xFF80) {
         // IO Registers
         // TODO: Algunos registros son de solo lectura o tienen efectos secundarios
-        gb->bus.io[address - 0xFF00] = value;
+
+        // Registros de la PPU: el dibujado tiene que llegar hasta aquí con
+        // los valores antiguos (solo cuesta algo con el backend FIFO)
+        if (address >= 0xFF40 && address <= 0xFF4B) {
+            ppu_sync(gb);
+        }
+
+        switch (address) {
+            case REG_P1_ADDR: // Joypad: selección de grupo
+                joypad_write(gb, value);
+                break;
+            case REG_SB_ADDR: // Puerto serie: dato y control
+            case REG_SC_ADDR:
+                serial_write(gb, address, value);
+                break;
+            case 0xFF04: // DIV, TIMA, TMA, TAC
+            case 0xFF05:
+            case 0xFF06:
+            case 0xFF07:
+                timer_write(gb, address, value);
+                break;
+            case 0xFF40: // LCDC: Control del LCD
+                ppu_write_lcdc(gb, value);
+                break;
+            case 0xFF41: // STAT: Bits 0-2 de solo lectura
+                ppu_write_stat(gb, value);
+                break;
+            case 0xFF44: // LY: Solo lectura
+                break;
+            case 0xFF45: // LYC: Afecta a la coincidencia de STAT
+                ppu_write_lyc(gb, value);
+                break;
+            case 0xFF46: // DMA: Transferencia a OAM
+                gb->bus.io[address - 0xFF00] = value;
+                dma_start(gb, value);
+                break;
+            default:
+                gb->bus.io[address - 0xFF00] = value;
+                break;
+        }
     }
     // HRAM Registers
     else if (address < 0xFFFF) {
@@ -0,0 +1,312 @@
+// src/cart.c
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cart.h"
+#include "hash.h"
+
+// Cabecera del cartucho
+#define HEADER_TYPE     0x0147
+#define HEADER_RAM_SIZE 0x0149
+
+static bool mbc_from_header(u8 type, u8* mbc) {
+    switch (type) {
+        case 0x00: case 0x08: case 0x09:
+            *mbc = MBC_NONE; return true;
+        case 0x01: case 0x02: case 0x03:
+            *mbc = MBC_1; return true;
+        case 0x0F: case 0x10: case 0x11: case 0x12: case 0x13:
+            *mbc = MBC_3; return true;
+        case 0x19: case 0x1A: case 0x1B: case 0x1C: case 0x1D: case 0x1E:
+            *mbc = MBC_5; return true;
+        default:
+            return false;
+    }
+}
+
+static size_t ram_size_from_header(u8 code) {
+    switch (code) {
+        case 0x02: return 1 * RAM_BANK_SIZE;
+        case 0x03: return 4 * RAM_BANK_SIZE;
+        case 0x04: return 16 * RAM_BANK_SIZE;
+        case 0x05: return 8 * RAM_BANK_SIZE;
+        default:   return 0;
+    }
+}
+
+// ----------------------------- Caché de ROM -----------------------------
+
+// Imágenes cargadas. La lista y el paso de refs a 0 van con el lock, así que
+// una imagen de la lista nunca está a medio liberar.
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static RomImage* cache;
+
+static void rom_unmap(const u8* data, size_t size, bool mapped) {
+    if (mapped) munmap((void*)data, size);
+    else free((void*)data);
+}
+
+// Mapea el fichero entero. Si no se puede (no todos los ficheros admiten
+// mmap), lo lee a memoria normal.
+static const u8* rom_map(const char* path, size_t* size, bool* mapped) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("No se puede abrir la ROM: %s\n", path);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < 0x8000) {
+        printf("ROM demasiado pequeña: %s\n", path);
+        close(fd);
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+
+    void* data = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fd, 0);
+    *mapped = data != MAP_FAILED;
+    if (!*mapped) {
+        data = malloc(*size);
+        size_t done = 0;
+        while (data && done < *size) {
+            ssize_t n = read(fd, (u8*)data + done, *size - done);
+            if (n <= 0) break;
+            done += (size_t)n;
+        }
+        if (data && done < *size) {
+            free(data);
+            data = NULL;
+        }
+        if (!data) printf("Error leyendo la ROM: %s\n", path);
+    }
+    close(fd);
+    return data;
+}
+
+// Imagen con el contenido de path: la de la caché si ya está, si no una nueva
+static RomImage* rom_acquire(const char* path) {
+    size_t size;
+    bool mapped;
+    const u8* data = rom_map(path, &size, &mapped);
+    if (!data) return NULL;
+    u64 hash = hash_bytes(data, size, HASH_SEED);
+
+    pthread_mutex_lock(&cache_lock);
+    RomImage* image = cache;
+    while (image && !(image->hash == hash && image->size == size && memcmp(image->data, data, size) == 0)) {
+        image = image->next;
+    }
+    if (image) {
+        __atomic_add_fetch(&image->refs, 1, __ATOMIC_RELAXED);
+    }
+    else if ((image = malloc(sizeof(RomImage)))) {
+        *image = (RomImage){ 1, size, data, hash, mapped, cache };
+        cache = image;
+        data = NULL; // Ahora es de la imagen
+    }
+    pthread_mutex_unlock(&cache_lock);
+
+    if (data) rom_unmap(data, size, mapped);
+    return image;
+}
+
+static void rom_release(RomImage* image) {
+    pthread_mutex_lock(&cache_lock);
+    bool last = __atomic_sub_fetch(&image->refs, 1, __ATOMIC_ACQ_REL) == 0;
+    if (last) {
+        RomImage** link = &cache;
+        while (*link != image) link = &(*link)->next;
+        *link = image->next;
+    }
+    pthread_mutex_unlock(&cache_lock);
+
+    if (last) {
+        rom_unmap(image->data, image->size, image->mapped);
+        free(image);
+    }
+}
+
+int cart_cached_images(void) {
+    int count = 0;
+    pthread_mutex_lock(&cache_lock);
+    for (RomImage* image = cache; image; image = image->next) count++;
+    pthread_mutex_unlock(&cache_lock);
+    return count;
+}
+
+// ------------------------ Referencias compartidas -----------------------
+
+static void bank_release(CartRamBank* bank) {
+    if (bank && __atomic_sub_fetch(&bank->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(bank);
+    }
+}
+
+static void share(u32* refs) {
+    __atomic_add_fetch(refs, 1, __ATOMIC_RELAXED);
+}
+
+// --------------------------- Carga ------------------------------------
+
+bool cart_load(Cart* cart, const char* path) {
+    memset(cart, 0, sizeof(*cart));
+
+    cart->image = rom_acquire(path);
+    if (!cart->image) return false;
+    cart->rom = cart->image->data;
+    cart->rom_size = cart->image->size;
+
+    if (!mbc_from_header(cart->rom[HEADER_TYPE], &cart->mbc)) {
+        printf("Tipo de cartucho no soportado: 0x%02X\n", cart->rom[HEADER_TYPE]);
+        cart_free(cart);
+        return false;
+    }
+
+    cart->ram_size = ram_size_from_header(cart->rom[HEADER_RAM_SIZE]);
+    cart->ram_banks = cart->ram_size / RAM_BANK_SIZE;
+    for (int n = 0; n < cart->ram_banks; n++) {
+        cart->ram[n] = calloc(1, sizeof(CartRamBank));
+        if (!cart->ram[n]) {
+            printf("Sin memoria para la RAM del cartucho\n");
+            cart_free(cart);
+            return false;
+        }
+        cart->ram[n]->refs = 1;
+    }
+    cart->rom_bank = 1;
+    return true;
+}
+
+void cart_free(Cart* cart) {
+    if (cart->image) rom_release(cart->image);
+    for (int n = 0; n < cart->ram_banks; n++) bank_release(cart->ram[n]);
+    memset(cart, 0, sizeof(*cart));
+}
+
+void cart_fork(Cart* child, const Cart* parent) {
+    *child = *parent;
+    if (child->image) share(&child->image->refs);
+    for (int n = 0; n < child->ram_banks; n++) share(&child->ram[n]->refs);
+}
+
+// ------------------------------- ROM -----------------------------------
+
+u8 cart_read(const Cart* cart, u16 address) {
+    if (!cart->rom) return 0xFF; // Sin cartucho
+
+    size_t offset;
+    if (address < ROM_BANK_SIZE) {
+        // En modo 1 el MBC1 también aplica los bits altos al banco 0
+        u16 bank = (cart->mbc == MBC_1 && cart->mode) ? (cart->rom_bank & 0x60) : 0;
+        offset = (size_t)bank * ROM_BANK_SIZE + address;
+    }
+    else {
+        offset = (size_t)cart->rom_bank * ROM_BANK_SIZE + (address - ROM_BANK_SIZE);
+    }
+    return cart->rom[offset % cart->rom_size];
+}
+
+void cart_write(Cart* cart, u16 address, u8 value) {
+    switch (cart->mbc) {
+        case MBC_NONE:
+            break;
+
+        case MBC_1:
+            if (address < 0x2000) {
+                cart->ram_enable = (value & 0x0F) == 0x0A;
+            }
+            else if (address < 0x4000) {
+                // 5 bits bajos del banco; el 0 se convierte en 1
+                u8 low = value & 0x1F;
+                if (low == 0) low = 1;
+                cart->rom_bank = (cart->rom_bank & 0x60) | low;
+            }
+            else if (address < 0x6000) {
+                // 2 bits: banco de RAM o bits 5-6 del banco de ROM
+                cart->ram_bank = value & 0x03;
+                cart->rom_bank = (cart->rom_bank & 0x1F) | ((value & 0x03) << 5);
+            }
+            else {
+                cart->mode = value & 0x01;
+            }
+            break;
+
+        case MBC_3:
+            if (address < 0x2000) {
+                cart->ram_enable = (value & 0x0F) == 0x0A;
+            }
+            else if (address < 0x4000) {
+                cart->rom_bank = (value & 0x7F) ? (value & 0x7F) : 1;
+            }
+            else if (address < 0x6000) {
+                // 0x08-0x0C seleccionan registros del RTC (no implementado)
+                cart->ram_bank = value & 0x0F;
+            }
+            break;
+
+        case MBC_5:
+            if (address < 0x2000) {
+                cart->ram_enable = (value & 0x0F) == 0x0A;
+            }
+            else if (address < 0x3000) {
+                cart->rom_bank = (cart->rom_bank & 0x100) | value;
+            }
+            else if (address < 0x4000) {
+                cart->rom_bank = (cart->rom_bank & 0xFF) | ((value & 0x01) << 8);
+            }
+            else if (address < 0x6000) {
+                cart->ram_bank = value & 0x0F;
+            }
+            break;
+    }
+}
+
+// --------------------------- RAM externa -------------------------------
+
+// Banco mapeado en $A000-$BFFF, o -1 si no hay RAM accesible
+static int ram_bank_index(const Cart* cart) {
+    if (!cart->ram_banks || !cart->ram_enable) return -1;
+
+    u8 bank = cart->ram_bank;
+    if (cart->mbc == MBC_1 && !cart->mode) bank = 0;
+    if (cart->mbc == MBC_3 && bank > 0x03) return -1; // RTC
+
+    return bank % cart->ram_banks;
+}
+
+const u8* cart_ram_bank(const Cart* cart, int n) {
+    return cart->ram[n]->data;
+}
+
+u8* cart_ram_bank_writable(Cart* cart, int n) {
+    CartRamBank* bank = cart->ram[n];
+
+    // Compartido con otra instancia: nos quedamos con una copia propia
+    if (__atomic_load_n(&bank->refs, __ATOMIC_ACQUIRE) > 1) {
+        CartRamBank* copy = malloc(sizeof(CartRamBank));
+        if (!copy) return NULL;
+        memcpy(copy->data, bank->data, RAM_BANK_SIZE);
+        copy->refs = 1;
+        bank_release(bank);
+        cart->ram[n] = bank = copy;
+    }
+    return bank->data;
+}
+
+u8 cart_read_ram(const Cart* cart, u16 address) {
+    int bank = ram_bank_index(cart);
+    return bank < 0 ? 0xFF : cart->ram[bank]->data[address - 0xA000];
+}
+
+void cart_write_ram(Cart* cart, u16 address, u8 value) {
+    int bank = ram_bank_index(cart);
+    if (bank < 0) return;
+
+    u8* data = cart_ram_bank_writable(cart, bank);
+    if (data) data[address - 0xA000] = value;
+}
@@ -808,8 +808,9 @@ void op_stop(GameBoy* gb) {
     // 2. Activamos el modo STOP
     gb->cpu.stopped = true;
 
-    // 3. TODO: Quirk de Hardware (DMG): Reset del DIV
+    // 3. Quirk de Hardware (DMG): Reset del DIV
     // Al entrar en STOP, el divisor interno del Timer se reinicia.
+    timer_reset_div(gb);
 }
 
 // -------------------------- INC r -------------------------
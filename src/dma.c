@@ -0,0 +1,81 @@
+// src/dma.c
+#include <string.h>
+#include "gb.h"
+
+// OAM DMA
+// La transferencia copia 160 bytes desde XX00-XX9F a la OAM ($FE00-$FE9F).
+// Mientras dura, la CPU solo puede acceder a la HRAM y a los registros de
+// I/O, por lo que el origen no puede cambiar durante la transferencia:
+// copiar todo de golpe al terminar da exactamente el mismo resultado que
+// copiar byte a byte. Una escritura en $FF46 a medias relanza la DMA.
+
+// Devuelve un puntero directo a la memoria de origen, o NULL si el origen
+// no está respaldado por un array de la consola (cartucho, I/O...)
+static const u8* dma_source_ptr(GameBoy* gb, u16 source) {
+    if (source >= 0x8000 && source < 0xA000) return &gb->bus.vram[source - 0x8000];
+    if (source >= 0xC000 && source < 0xE000) return &gb->bus.wram[source - 0xC000];
+    // $E000-$FDFF es el espejo de la WRAM; el último tramo no cabe entero
+    if (source >= 0xE000 && source <= 0xFD00) return &gb->bus.wram[source - 0xE000];
+    return NULL;
+}
+
+// Copia a la OAM los bytes [from, to) de la transferencia en curso
+static void dma_copy(GameBoy* gb, u8 from, u8 to) {
+    if (from >= to) return;
+
+    const u8* src = dma_source_ptr(gb, gb->dma.source);
+    if (src) {
+        memcpy(&gb->bus.oam[from], &src[from], to - from);
+    }
+    else {
+        // Origen sin array directo: leemos saltándonos el bloqueo del bus
+        u8 mode = gb->bus.access_mode;
+        gb->bus.access_mode = 0;
+        for (int i = from; i < to; i++) {
+            gb->bus.oam[i] = bus_read(gb, gb->dma.source + i);
+        }
+        gb->bus.access_mode = mode;
+    }
+    gb->dma.copied = to;
+    bus_mark_dirty(&gb->bus, 0xFE00);
+
+    // La PPU tiene que reindexar los sprites copiados
+    gb->ppu.sprite_dirty |= ALL_SPRITES;
+}
+
+void dma_start(GameBoy* gb, u8 value) {
+    // Si había una transferencia en curso, la nueva la sustituye.
+    // Conservamos en la OAM lo que la anterior ya hubiera copiado.
+    if (gb->dma.active) {
+        dma_sync(gb);
+    }
+
+    gb->dma.active = true;
+    gb->dma.source = (u16)value << 8;
+    gb->dma.start = gb->ticks;
+    gb->dma.copied = 0;
+
+    // Bloqueamos el bus: a partir de aquí la CPU solo ve I/O y la HRAM
+    gb->bus.access_mode |= BUS_MODE_DMA;
+
+    sched_schedule(gb, EVENT_DMA, gb->ticks + DMA_DURATION_TICKS);
+}
+
+void dma_sync(GameBoy* gb) {
+    if (!gb->dma.active) return;
+
+    u64 elapsed = gb->ticks - gb->dma.start;
+    if (elapsed < DMA_STARTUP_TICKS) return;
+
+    u64 done = (elapsed - DMA_STARTUP_TICKS) / 4;
+    if (done > DMA_LENGTH) done = DMA_LENGTH;
+
+    dma_copy(gb, gb->dma.copied, (u8)done);
+}
+
+// Fin de la transferencia: volcamos lo que falte y liberamos el bus
+void dma_event(GameBoy* gb) {
+    dma_copy(gb, gb->dma.copied, DMA_LENGTH);
+    gb->dma.active = false;
+    gb->bus.access_mode &= ~BUS_MODE_DMA;
+}
@@ -0,0 +1,74 @@
+// src/framebuffer.c
+#include <string.h>
+#include "framebuffer.h"
+#include "tile.h"
+
+// Tonos de la DMG (0 = blanco) en escala de grises
+static const u8 default_palette[4][4] = {
+    { 0xFF, 0xFF, 0xFF, 0xFF },
+    { 0xAA, 0xAA, 0xAA, 0xFF },
+    { 0x55, 0x55, 0x55, 0xFF },
+    { 0x00, 0x00, 0x00, 0xFF },
+};
+
+void fb_init(FrameBuffer* fb) {
+    memset(fb, 0, sizeof(*fb));
+    fb->back = 0;
+    fb->last = 1;
+    fb->middle = 1;
+    fb->front = 2;
+    fb_set_palette(fb, default_palette);
+}
+
+void fb_set_palette(FrameBuffer* fb, const u8 palette[4][4]) {
+    memcpy(fb->palette, palette, sizeof(fb->palette));
+}
+
+void fb_publish(FrameBuffer* fb, u64 frame) {
+    Frame* done = &fb->frames[fb->back];
+    done->frame = frame;
+    memcpy(done->palette, fb->palette, sizeof(done->palette));
+    done->seq = fb->published + 1;
+
+    // El RELEASE garantiza que el consumidor ve los píxeles antes que el índice
+    u32 old = __atomic_exchange_n(&fb->middle, (u32)fb->back | FB_FRESH, __ATOMIC_ACQ_REL);
+    fb->last = fb->back;
+    fb->back = old & ~FB_FRESH;
+
+    __atomic_store_n(&fb->published, done->seq, __ATOMIC_RELEASE);
+}
+
+const Frame* fb_acquire(FrameBuffer* fb) {
+    if (__atomic_load_n(&fb->middle, __ATOMIC_ACQUIRE) & FB_FRESH) {
+        u32 old = __atomic_exchange_n(&fb->middle, (u32)fb->front, __ATOMIC_ACQ_REL);
+        fb->front = old & ~FB_FRESH;
+
+        const Frame* frame = &fb->frames[fb->front];
+        fb->dropped += frame->seq - fb->consumed - 1;
+        fb->consumed = frame->seq;
+    }
+
+    if (fb->consumed == 0) return NULL;
+    return &fb->frames[fb->front];
+}
+
+// ---------------------------- Conversiones -----------------------------
+
+void fb_unpack(const Frame* frame, u8* out) {
+    static const u8 identity[4] = { 0, 1, 2, 3 };
+    tile_unpack(&frame->pixels[0][0], out, identity, FB_PIXELS);
+}
+
+void fb_to_gray(const Frame* frame, u8* out) {
+    // Luminancia BT.601 de cada color de la paleta
+    u8 gray[4];
+    for (int i = 0; i < 4; i++) {
+        const u8* c = frame->palette[i];
+        gray[i] = (c[0] * 77 + c[1] * 150 + c[2] * 29) >> 8;
+    }
+    tile_unpack(&frame->pixels[0][0], out, gray, FB_PIXELS);
+}
+
+void fb_to_rgba(const Frame* frame, u8* out) {
+    tile_unpack_rgba(&frame->pixels[0][0], out, frame->palette, FB_PIXELS);
+}
@@ -0,0 +1,110 @@
+// src/gb.c
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gb.h"
+
+void gb_init(GameBoy* gb, const GbConfig* config) {
+    static const GbConfig defaults = { .ppu_backend = PPU_BACKEND_FAST };
+    if (!config) config = &defaults;
+
+    memset(gb, 0, sizeof(*gb));
+
+    cpu_init(&gb->cpu);
+    sched_init(&gb->sched);
+    timer_init(gb);
+    joypad_init(gb);
+    serial_init(gb);
+    apu_init(gb, config->sample_rate);
+    if (config->no_audio) apu_set_synth(gb, false);
+    fb_init(&gb->fb);
+    ppu_init(gb, config->ppu_backend);
+}
+
+GameBoy* gb_fork(const GameBoy* parent) {
+    GameBoy* child = malloc(sizeof(GameBoy));
+    if (!child) return NULL;
+    gb_init(child, NULL);
+    gb_fork_into(child, parent);
+    return child;
+}
+
+void gb_fork_into(GameBoy* child, const GameBoy* parent) {
+    if (child == parent) return;
+
+    cart_free(&child->cart);
+    cart_fork(&child->cart, &parent->cart);
+
+    // Memoria interna (la plana del modo test no)
+    Bus* bus = &child->bus;
+    const Bus* from = &parent->bus;
+    memcpy(bus->wram, from->wram, WRAM_SIZE);
+    memcpy(bus->vram, from->vram, VRAM_SIZE);
+    memcpy(bus->hram, from->hram, HRAM_SIZE);
+    memcpy(bus->oam, from->oam, OAM_SIZE);
+    memcpy(bus->io, from->io, sizeof(bus->io));
+    memcpy(bus->dirty, from->dirty, sizeof(bus->dirty));
+    bus->access_mode = from->access_mode;
+
+    child->cpu = parent->cpu;
+    child->paused = parent->paused;
+    child->ticks = parent->ticks;
+    child->sched = parent->sched;
+    child->dma = parent->dma;
+    child->timer = parent->timer;
+    child->joypad = parent->joypad;
+
+    // PPU: todo menos los tiles decodificados (24KB), que se vuelven a
+    // decodificar la primera vez que se usen
+    memcpy(&child->ppu.tile_dirty, &parent->ppu.tile_dirty,
+           sizeof(Ppu) - offsetof(Ppu, tile_dirty));
+    memset(child->ppu.tile_dirty, 0xFF, sizeof(child->ppu.tile_dirty));
+
+    // APU: los buffers de salida solo si se está sintetizando
+    memcpy(&child->apu, &parent->apu, offsetof(Apu, left));
+    if (parent->apu.synth) {
+        child->apu.left = parent->apu.left;
+        child->apu.right = parent->apu.right;
+    }
+    else {
+        memcpy(&child->apu.left, &parent->apu.left, offsetof(Blip, buf));
+        memcpy(&child->apu.right, &parent->apu.right, offsetof(Blip, buf));
+    }
+
+    // Frames: el que se está dibujando y el último publicado (la caché de
+    // líneas copia de él)
+    FrameBuffer* fb = &child->fb;
+    memcpy(fb->frames[fb->back].pixels, parent->fb.frames[parent->fb.back].pixels, FB_FRAME_BYTES);
+    memcpy(fb->frames[fb->last].pixels, parent->fb.frames[parent->fb.last].pixels, FB_FRAME_BYTES);
+    memcpy(fb->palette, parent->fb.palette, sizeof(fb->palette));
+}
+
+void gb_free(GameBoy* gb) {
+    if (!gb) return;
+    cart_free(&gb->cart);
+    free(gb);
+}
+
+int gb_step(GameBoy* gb) {
+    // cpu_step devuelve M-Cycles; el reloj del sistema cuenta T-Cycles
+    int ticks = cpu_step(gb) * 4;
+    gb->ticks += ticks;
+
+    // Única comprobación por instrucción: ¿ha vencido algún evento?
+    if (gb->ticks >= gb->sched.next) {
+        sched_run(gb);
+    }
+
+    return ticks;
+}
+
+u64 gb_run_frame(GameBoy* gb) {
+    u64 start = gb->ticks;
+    u64 frame = gb->ppu.frame_count;
+
+    while (gb->ppu.frame_count == frame && gb->ticks - start < FRAME_TICKS) {
+        // En STOP el reloj no avanza: no hay nada más que hacer en este frame
+        if (gb_step(gb) == 0) break;
+    }
+    return gb->ticks - start;
+}
@@ -0,0 +1,35 @@
+// src/hash.c
+#include <string.h>
+#include "hash.h"
+
+// Mezcla final de MurmurHash3: cada bit de entrada cambia, de media, la
+// mitad de los bits de salida
+static u64 fmix64(u64 h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    return h ^ (h >> 33);
+}
+
+u64 hash_combine(u64 h, u64 v) {
+    return fmix64(h ^ v);
+}
+
+// De 8 en 8 bytes (el resto, completado con ceros), mezclando cada palabra
+// con lo acumulado: un simple xor y multiplicación deja los bits altos de
+// cada palabra sin propagar y dos cambios en el bit 63 se anulan
+u64 hash_bytes(const u8* data, size_t size, u64 h) {
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        u64 word;
+        memcpy(&word, data + i, 8);
+        h = fmix64(h ^ word);
+    }
+    if (i < size) {
+        u64 word = 0;
+        memcpy(&word, data + i, size - i);
+        h = fmix64(h ^ word);
+    }
+    return fmix64(h ^ size);
+}
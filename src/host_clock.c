@@ -0,0 +1,10 @@
+// src/host_clock.c
+#define _POSIX_C_SOURCE 200809L
+#include <time.h>
+#include "host_clock.h"
+
+u64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+}
@@ -0,0 +1,41 @@
+// src/joypad.c
+#include "gb.h"
+
+// Líneas 0-3 de P1 (a 1 = ninguna tecla pulsada en los grupos elegidos)
+static u8 joypad_lines(const Joypad* joypad) {
+    u8 pressed = 0;
+    if (!BIT(joypad->select, P1_SELECT_DPAD)) pressed |= joypad->buttons & 0x0F;
+    if (!BIT(joypad->select, P1_SELECT_BUTTONS)) pressed |= joypad->buttons >> 4;
+    return ~pressed & 0x0F;
+}
+
+// Aplica un cambio y pide la interrupción si alguna línea ha bajado
+static void joypad_update(GameBoy* gb, u8 buttons, u8 select) {
+    u8 before = joypad_lines(&gb->joypad);
+    gb->joypad.buttons = buttons;
+    gb->joypad.select = select & 0x30;
+    u8 after = joypad_lines(&gb->joypad);
+
+    if (before & ~after) {
+        cpu_request_interrupt(gb, INT_JOYPAD);
+        // Es lo único que saca a la CPU de STOP
+        gb->cpu.stopped = false;
+    }
+}
+
+void joypad_init(GameBoy* gb) {
+    gb->joypad.buttons = 0;
+    gb->joypad.select = 0x30;
+}
+
+void joypad_set(GameBoy* gb, u8 buttons) {
+    joypad_update(gb, buttons, gb->joypad.select);
+}
+
+u8 joypad_read(GameBoy* gb) {
+    return 0xC0 | gb->joypad.select | joypad_lines(&gb->joypad);
+}
+
+void joypad_write(GameBoy* gb, u8 value) {
+    joypad_update(gb, gb->joypad.buttons, value);
+}
@@ -1,9 +1,209 @@
+#include <signal.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "gb.h" // Incluir solo gb.h nos da acceso a todo
 #include "tests.h" // Prueba de opcodes
+#include "bench.h" // Microbenchmarks
+#include "batch.h" // Ejecución por lotes
+#include "video_out.h" // Salida de vídeo
+#include "movie.h" // Películas (entrada grabada)
+#include "runahead.h" // Run-ahead
+
+// Frecuencia de frames de la DMG: 4194304 Hz / 70224 ticks por frame
+#define FRAME_RATE_NUM 262144
+#define FRAME_RATE_DEN 4389
+
+// gameboy-emu --video-out <fichero|-> [--format y4m|rgb|indexed]
+//             [--scale 2x|3x|4x|scale2x] [--frames N] [--skip N]
+//             [--movie <fichero> [--seek N]] [--runahead K] <rom>
+// Emula sin ventana y vuelca los frames. --frames fija el número exacto de
+// frames escritos (0 = sin límite) y --skip N escribe uno de cada N (los
+// demás ni se dibujan). Con --movie la entrada sale de una película, desde
+// su frame --seek (por el keyframe más cercano), hasta que se acaba.
+// --scale amplía cada frame con ese filtro (véase scale.h; no con indexed).
+// --runahead K vuelca lo que se vería K frames más tarde (véase runahead.h)
+// y al final informa de lo que cuesta.
+// Los mensajes van a stderr: stdout puede ser el vídeo.
+static int video_main(int argc, char** argv) {
+    const char* path = NULL;
+    const char* rom = NULL;
+    VideoFormat format = VIDEO_FORMAT_Y4M;
+    int scale = -1;
+    u64 frames = 0;
+    u32 skip = 1;
+    const char* movie_path = NULL;
+    u64 seek = 0;
+    u32 runahead = 0;
+
+    for (int i = 0; i < argc; i++) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--video-out") == 0 && has_value) {
+            path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--format") == 0 && has_value) {
+            if (!video_format_parse(argv[++i], &format)) {
+                fprintf(stderr, "Formato desconocido: %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--scale") == 0 && has_value) {
+            ScaleFilter filter;
+            if (!scale_filter_parse(argv[++i], &filter)) {
+                fprintf(stderr, "Filtro de escalado desconocido: %s\n", argv[i]);
+                return 1;
+            }
+            scale = filter;
+        }
+        else if (strcmp(argv[i], "--frames") == 0 && has_value) {
+            frames = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--skip") == 0 && has_value) {
+            skip = (u32)strtoul(argv[++i], NULL, 10);
+            if (skip == 0) skip = 1;
+        }
+        else if (strcmp(argv[i], "--movie") == 0 && has_value) {
+            movie_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "--seek") == 0 && has_value) {
+            seek = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--runahead") == 0 && has_value) {
+            runahead = (u32)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strncmp(argv[i], "--", 2) == 0) {
+            fprintf(stderr, "Opción desconocida o sin valor: %s\n", argv[i]);
+            return 1;
+        }
+        else {
+            rom = argv[i];
+        }
+    }
+    if (!path || !rom) {
+        fprintf(stderr, "Uso: gameboy-emu --video-out <fichero|-> [--format y4m|rgb|indexed] "
+                        "[--scale 2x|3x|4x|scale2x] [--frames N] [--skip N] [--movie <fichero> [--seek N]] "
+                        "[--runahead K] <rom>\n");
+        return 1;
+    }
+    if (scale >= 0 && format == VIDEO_FORMAT_INDEXED) {
+        fprintf(stderr, "--scale no vale con --format indexed\n");
+        return 1;
+    }
+
+    // Solo vídeo: la APU no necesita generar audio
+    static GameBoy gb;
+    GbConfig config = { .no_audio = true };
+    gb_init(&gb, &config);
+    if (!cart_load(&gb.cart, rom)) return 1;
+    if (skip > 1) ppu_set_render_policy(&gb, PPU_RENDER_EVERY_N, skip);
+
+    static Movie movie;
+    if (movie_path) {
+        if (!movie_load(&movie, movie_path)) {
+            fprintf(stderr, "No se puede leer la película: %s\n", movie_path);
+            cart_free(&gb.cart);
+            return 1;
+        }
+        if (!movie_seek(&movie, &gb, seek)) {
+            fprintf(stderr, "No se puede ir al frame %llu (fuera de la película, o es de otra ROM)\n", (unsigned long long)seek);
+            movie_free(&movie);
+            cart_free(&gb.cart);
+            return 1;
+        }
+    }
+
+    static RunAhead ra;
+    if (!runahead_init(&ra, &gb, runahead)) {
+        fprintf(stderr, "--runahead: como mucho %d frames\n", RUNAHEAD_MAX_FRAMES);
+        movie_free(&movie);
+        cart_free(&gb.cart);
+        return 1;
+    }
+
+    VideoOut* video = video_out_open(path, format, scale, FRAME_RATE_NUM, FRAME_RATE_DEN * skip);
+    if (!video) {
+        fprintf(stderr, "No se puede abrir la salida: %s\n", path);
+        runahead_free(&ra);
+        movie_free(&movie);
+        cart_free(&gb.cart);
+        return 1;
+    }
+
+    // Frame en blanco (tono 0) para cuando el LCD está apagado
+    static Frame blank;
+    memcpy(blank.palette, gb.fb.palette, sizeof(blank.palette));
+
+    u64 published = gb.fb.published;
+    u64 lcd_off = 0;
+    u64 written = 0;
+    bool ok = true;
+
+    while (ok && (frames == 0 || written < frames)) {
+        u8 buttons = 0;
+        if (movie_path) {
+            if (movie.position >= movie.frames) {
+                fprintf(stderr, "Fin de la película (frame %llu)\n", (unsigned long long)movie.frames);
+                break;
+            }
+            buttons = movie.inputs[movie.position++];
+        }
+        runahead_frame(&ra, &gb, buttons);
+        if (gb.cpu.stopped) {
+            fprintf(stderr, "CPU en STOP: fin de la emulación\n");
+            break;
+        }
+
+        if (gb.fb.published != published) {
+            // El frame recién publicado sigue intacto hasta el próximo VBlank
+            published = gb.fb.published;
+            ok = video_out_push(video, &gb.fb.frames[gb.fb.last]);
+            if (ok) written++;
+        }
+        else if (!BIT(gb.bus.io[REG_LCDC], LCDC_LCD_ENABLE)) {
+            // Con el LCD apagado no hay VBlank: un frame en blanco mantiene
+            // la duración real del vídeo
+            if (lcd_off++ % skip == 0) {
+                ok = video_out_push(video, &blank);
+                if (ok) written++;
+            }
+        }
+    }
+
+    if (!video_out_close(video)) ok = false;
+    if (runahead) {
+        fprintf(stderr, "Run-ahead de %u frames: %.1f us de más por frame\n", runahead, runahead_extra_us(&ra));
+    }
+    runahead_free(&ra);
+    movie_free(&movie);
+    cart_free(&gb.cart);
+
+    fprintf(stderr, "%llu frames escritos%s\n", (unsigned long long)written,
+            ok ? "" : " (error de escritura)");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    // Si el otro extremo de una tubería (--video-out -) se cierra, queremos
+    // un error de escritura (EPIPE) en lugar de que SIGPIPE mate el proceso
+    signal(SIGPIPE, SIG_IGN);
+
+    // gameboy-emu bench [nombre...]
+    if (argc > 1 && strcmp(argv[1], "bench") == 0) {
+        return bench_main(argc - 2, argv + 2);
+    }
+
+    // gameboy-emu batch <trabajos> ...
+    if (argc > 1 && strcmp(argv[1], "batch") == 0) {
+        return batch_main(argc - 2, argv + 2);
+    }
+
+    // gameboy-emu --video-out ...
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--video-out") == 0) {
+            return video_main(argc - 1, argv + 1);
+        }
+    }
 
-int main(void) {
     printf("--- TEST DE CPU ---\n");
     printf("Opcodes 0x00 - 0xFF\n");
     char test_dir[] = "tests/sm83/v1/";
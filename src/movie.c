@@ -0,0 +1,223 @@
+// src/movie.c
+#include <stdlib.h>
+#include <string.h>
+#include "gb.h"
+#include "state.h"
+#include "movie.h"
+
+// ------------------------------ Memoria --------------------------------
+
+void movie_init(Movie* movie, u32 keyframe_interval) {
+    memset(movie, 0, sizeof(*movie));
+    movie->keyframe_interval = keyframe_interval ? keyframe_interval : MOVIE_DEFAULT_KEYFRAME_INTERVAL;
+}
+
+// Descarta los keyframes posteriores a frame
+static void drop_keyframes_after(Movie* movie, u64 frame) {
+    while (movie->keyframe_count && movie->keyframes[movie->keyframe_count - 1].frame > frame) {
+        free(movie->keyframes[--movie->keyframe_count].state);
+    }
+}
+
+void movie_free(Movie* movie) {
+    for (u32 k = 0; k < movie->keyframe_count; k++) free(movie->keyframes[k].state);
+    free(movie->keyframes);
+    free(movie->inputs);
+    memset(movie, 0, sizeof(*movie));
+}
+
+// Añade un keyframe (toma posesión de state)
+static bool add_keyframe(Movie* movie, u64 frame, u8* state, size_t size) {
+    if (movie->keyframe_count == movie->keyframes_capacity) {
+        u32 capacity = movie->keyframes_capacity ? movie->keyframes_capacity * 2 : 16;
+        MovieKeyframe* keyframes = realloc(movie->keyframes, capacity * sizeof(MovieKeyframe));
+        if (!keyframes) return false;
+        movie->keyframes = keyframes;
+        movie->keyframes_capacity = capacity;
+    }
+    movie->keyframes[movie->keyframe_count++] = (MovieKeyframe){ frame, state, size };
+    return true;
+}
+
+static bool save_keyframe(Movie* movie, const GameBoy* gb, u64 frame) {
+    size_t size = gb_state_size(gb);
+    u8* state = malloc(size);
+    if (!state || !gb_save_state(gb, state, size) || !add_keyframe(movie, frame, state, size)) {
+        free(state);
+        return false;
+    }
+    return true;
+}
+
+static bool reserve_inputs(Movie* movie, u64 count) {
+    if (count <= movie->inputs_capacity) return true;
+
+    u64 capacity = movie->inputs_capacity ? movie->inputs_capacity : 4096;
+    while (capacity < count) capacity = capacity <= UINT64_MAX / 2 ? capacity * 2 : count;
+    if (capacity > SIZE_MAX) return false;
+    u8* inputs = realloc(movie->inputs, capacity);
+    if (!inputs) return false;
+    movie->inputs = inputs;
+    movie->inputs_capacity = capacity;
+    return true;
+}
+
+// ------------------------------ Grabación ------------------------------
+
+bool movie_record_start(Movie* movie, const GameBoy* gb) {
+    u32 interval = movie->keyframe_interval;
+    movie_free(movie);
+    movie_init(movie, interval);
+    return save_keyframe(movie, gb, 0);
+}
+
+bool movie_record_frame(Movie* movie, GameBoy* gb, u8 buttons) {
+    u64 frame = movie->position;
+    if (movie->keyframe_count == 0 || !reserve_inputs(movie, frame + 1)) return false;
+
+    // Se graba encima de lo que hubiera desde aquí
+    movie->frames = frame;
+    drop_keyframes_after(movie, frame);
+
+    const MovieKeyframe* last = &movie->keyframes[movie->keyframe_count - 1];
+    if (frame % movie->keyframe_interval == 0 && last->frame != frame) {
+        if (!save_keyframe(movie, gb, frame)) return false;
+    }
+
+    movie->inputs[frame] = buttons;
+    movie->frames = frame + 1;
+    return movie_play_frame(movie, gb);
+}
+
+// ---------------------------- Reproducción -----------------------------
+
+bool movie_play_frame(Movie* movie, GameBoy* gb) {
+    if (movie->position >= movie->frames) return false;
+
+    joypad_set(gb, movie->inputs[movie->position++]);
+    gb_run_frame(gb);
+    return true;
+}
+
+bool movie_seek(Movie* movie, GameBoy* gb, u64 frame) {
+    if (frame > movie->frames || movie->keyframe_count == 0) return false;
+
+    // Último keyframe anterior o igual (búsqueda binaria)
+    u32 lo = 0;
+    u32 hi = movie->keyframe_count;
+    while (hi - lo > 1) {
+        u32 mid = (lo + hi) / 2;
+        if (movie->keyframes[mid].frame <= frame) lo = mid;
+        else hi = mid;
+    }
+    const MovieKeyframe* key = &movie->keyframes[lo];
+    if (!gb_load_state(gb, key->state, key->size)) return false;
+    movie->position = key->frame;
+
+    // Hasta el frame anterior, sin dibujar; ese último sí, para que el frame
+    // publicado sea el que se vería al llegar aquí
+    u8 policy = gb->ppu.render_policy;
+    u32 interval = gb->ppu.render_interval;
+    if (frame - movie->position > 1) ppu_set_render_policy(gb, PPU_RENDER_NEVER, 0);
+    while (movie->position < frame) {
+        if (movie->position + 1 == frame) ppu_set_render_policy(gb, policy, interval);
+        movie_play_frame(movie, gb);
+    }
+    return true;
+}
+
+// ------------------------------ Ficheros -------------------------------
+
+static bool write_u32(FILE* file, u32 v) {
+    u8 b[4] = { v, v >> 8, v >> 16, v >> 24 };
+    return fwrite(b, 1, 4, file) == 4;
+}
+
+static bool write_u64(FILE* file, u64 v) {
+    return write_u32(file, (u32)v) && write_u32(file, (u32)(v >> 32));
+}
+
+static bool read_u32(FILE* file, u32* v) {
+    u8 b[4];
+    if (fread(b, 1, 4, file) != 4) return false;
+    *v = b[0] | (b[1] << 8) | (b[2] << 16) | ((u32)b[3] << 24);
+    return true;
+}
+
+static bool read_u64(FILE* file, u64* v) {
+    u32 lo, hi;
+    if (!read_u32(file, &lo) || !read_u32(file, &hi)) return false;
+    *v = lo | ((u64)hi << 32);
+    return true;
+}
+
+bool movie_save(const Movie* movie, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+
+    bool ok = fwrite(MOVIE_MAGIC, 1, 4, file) == 4
+           && write_u32(file, MOVIE_VERSION)
+           && write_u32(file, movie->keyframe_interval)
+           && write_u64(file, movie->frames)
+           && fwrite(movie->inputs, 1, movie->frames, file) == movie->frames;
+
+    // Solo los keyframes que siguen dentro de la película
+    u32 count = 0;
+    while (count < movie->keyframe_count && movie->keyframes[count].frame <= movie->frames) count++;
+    ok = ok && write_u32(file, count);
+    for (u32 k = 0; ok && k < count; k++) {
+        const MovieKeyframe* key = &movie->keyframes[k];
+        ok = write_u64(file, key->frame)
+          && write_u32(file, (u32)key->size)
+          && fwrite(key->state, 1, key->size, file) == key->size;
+    }
+
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+// Bytes que quedan hasta el final del fichero: lo que dice la cabecera no
+// puede pedir más memoria que la que el propio fichero trae
+static u64 bytes_left(FILE* file) {
+    long pos = ftell(file);
+    if (pos < 0 || fseek(file, 0, SEEK_END) != 0) return 0;
+    long end = ftell(file);
+    if (end < pos || fseek(file, pos, SEEK_SET) != 0) return 0;
+    return (u64)(end - pos);
+}
+
+bool movie_load(Movie* movie, const char* path) {
+    movie_init(movie, 0);
+
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    char magic[4];
+    u32 version = 0, interval = 0, count = 0;
+    u64 frames = 0;
+    bool ok = fread(magic, 1, 4, file) == 4 && memcmp(magic, MOVIE_MAGIC, 4) == 0
+           && read_u32(file, &version) && version == MOVIE_VERSION
+           && read_u32(file, &interval) && interval > 0
+           && read_u64(file, &frames) && frames <= bytes_left(file)
+           && reserve_inputs(movie, frames ? frames : 1)
+           && fread(movie->inputs, 1, frames, file) == frames
+           && read_u32(file, &count) && count > 0;
+    movie->keyframe_interval = interval;
+    movie->frames = ok ? frames : 0;
+
+    // Los keyframes tienen que estar en orden y empezar en el 0
+    for (u32 k = 0; ok && k < count; k++) {
+        u64 frame;
+        u32 size;
+        ok = read_u64(file, &frame) && read_u32(file, &size) && frame <= frames
+          && (k == 0 ? frame == 0 : frame > movie->keyframes[k - 1].frame)
+          && size <= bytes_left(file);
+        u8* state = ok ? malloc(size) : NULL;
+        ok = state && fread(state, 1, size, file) == size && add_keyframe(movie, frame, state, size);
+        if (!ok) free(state);
+    }
+    fclose(file);
+
+    if (!ok) movie_free(movie);
+    return ok;
+}
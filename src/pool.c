@@ -0,0 +1,221 @@
+// src/pool.c
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "pool.h"
+
+typedef struct {
+    PoolTaskFn run;
+    void* arg;
+} PoolTask;
+
+// Cola doble de un hilo: tareas [top, bottom), en tasks[i % capacity].
+// Los índices solo crecen. Cada cola empieza en su propia línea de caché
+// (el array se reserva alineado a 64).
+typedef struct {
+    pthread_mutex_t lock __attribute__((aligned(64)));
+    PoolTask* tasks;
+    u64 top;
+    u64 bottom;
+} PoolQueue;
+
+typedef struct {
+    WorkPool* pool;
+    int index;
+    pthread_t thread;
+} PoolWorker;
+
+struct WorkPool {
+    int threads;
+    u32 capacity;
+    PoolQueue* queues;
+    PoolWorker* workers;
+    u32 next;       // Cola de la siguiente pool_submit
+    u32 pending;    // Tareas sin terminar (atómico)
+    u64 steals;     // (atómico)
+
+    // Para dormir cuando no hay nada que robar
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+};
+
+// ------------------------------- Colas ---------------------------------
+
+static u64 queue_size(PoolQueue* queue) {
+    pthread_mutex_lock(&queue->lock);
+    u64 size = queue->bottom - queue->top;
+    pthread_mutex_unlock(&queue->lock);
+    return size;
+}
+
+// Devuelve las tareas que quedan en la cola
+static u64 push_bottom(WorkPool* pool, PoolQueue* queue, PoolTask task) {
+    pthread_mutex_lock(&queue->lock);
+    queue->tasks[queue->bottom++ % pool->capacity] = task;
+    u64 size = queue->bottom - queue->top;
+    pthread_mutex_unlock(&queue->lock);
+    return size;
+}
+
+static bool pop_bottom(WorkPool* pool, PoolQueue* queue, PoolTask* task) {
+    pthread_mutex_lock(&queue->lock);
+    bool found = queue->bottom > queue->top;
+    if (found) *task = queue->tasks[--queue->bottom % pool->capacity];
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+static bool steal_top(WorkPool* pool, PoolQueue* queue, PoolTask* task) {
+    pthread_mutex_lock(&queue->lock);
+    bool found = queue->bottom > queue->top;
+    if (found) *task = queue->tasks[queue->top++ % pool->capacity];
+    pthread_mutex_unlock(&queue->lock);
+    return found;
+}
+
+// Roba de los demás, empezando por el siguiente
+static bool steal(WorkPool* pool, int index, PoolTask* task) {
+    for (int i = 1; i < pool->threads; i++) {
+        if (steal_top(pool, &pool->queues[(index + i) % pool->threads], task)) {
+            __atomic_add_fetch(&pool->steals, 1, __ATOMIC_RELAXED);
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool any_queued(WorkPool* pool) {
+    for (int i = 0; i < pool->threads; i++) {
+        if (queue_size(&pool->queues[i])) return true;
+    }
+    return false;
+}
+
+// ------------------------------- Hilos ---------------------------------
+
+static void wake(WorkPool* pool, bool all) {
+    pthread_mutex_lock(&pool->lock);
+    if (all) pthread_cond_broadcast(&pool->wake);
+    else pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static void* worker_main(void* arg) {
+    PoolWorker* worker = arg;
+    WorkPool* pool = worker->pool;
+    PoolQueue* own = &pool->queues[worker->index];
+
+    for (;;) {
+        PoolTask task;
+        if (pop_bottom(pool, own, &task) || steal(pool, worker->index, &task)) {
+            if (task.run(task.arg, worker->index)) {
+                // Vuelve a la cola. Si hay más, alguien dormido puede robarlas.
+                if (push_bottom(pool, own, task) > 1) wake(pool, false);
+            }
+            else if (__atomic_sub_fetch(&pool->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+                wake(pool, true);
+            }
+            continue;
+        }
+
+        // Nada que hacer: a dormir hasta que haya algo que robar o se acabe
+        pthread_mutex_lock(&pool->lock);
+        while (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) > 0 && !any_queued(pool)) {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+        if (__atomic_load_n(&pool->pending, __ATOMIC_ACQUIRE) == 0) break;
+    }
+    return NULL;
+}
+
+// ------------------------------ Interfaz -------------------------------
+
+int pool_cpu_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+WorkPool* pool_create(int threads, u32 capacity) {
+    WorkPool* pool = calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+
+    pool->threads = threads > 0 ? threads : pool_cpu_count();
+    pool->capacity = capacity ? capacity : 1;
+    void* queues = NULL;
+    if (posix_memalign(&queues, sizeof(PoolQueue), sizeof(PoolQueue) * pool->threads) == 0) {
+        memset(queues, 0, sizeof(PoolQueue) * pool->threads);
+        pool->queues = queues;
+    }
+    pool->workers = calloc(pool->threads, sizeof(PoolWorker));
+    if (!pool->queues || !pool->workers) {
+        free(pool->queues);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    // Cualquier cola puede acabar con todas las tareas
+    bool ok = true;
+    for (int i = 0; i < pool->threads; i++) {
+        pthread_mutex_init(&pool->queues[i].lock, NULL);
+        pool->queues[i].tasks = malloc(sizeof(PoolTask) * pool->capacity);
+        if (!pool->queues[i].tasks) ok = false;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+
+    if (!ok) {
+        pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void pool_destroy(WorkPool* pool) {
+    if (!pool) return;
+    for (int i = 0; i < pool->threads; i++) {
+        pthread_mutex_destroy(&pool->queues[i].lock);
+        free(pool->queues[i].tasks);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->wake);
+    free(pool->queues);
+    free(pool->workers);
+    free(pool);
+}
+
+bool pool_submit(WorkPool* pool, PoolTaskFn run, void* arg) {
+    if (pool->pending == pool->capacity) return false;
+
+    PoolQueue* queue = &pool->queues[pool->next++ % pool->threads];
+    push_bottom(pool, queue, (PoolTask){ run, arg });
+    pool->pending++;
+    return true;
+}
+
+void pool_run(WorkPool* pool) {
+    if (pool->pending == 0) return;
+
+    // El hilo que llama es el 0
+    for (int i = 0; i < pool->threads; i++) {
+        pool->workers[i] = (PoolWorker){ pool, i, pthread_self() };
+    }
+    int started = 1;
+    for (int i = 1; i < pool->threads; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) break;
+        started++;
+    }
+    worker_main(&pool->workers[0]);
+    for (int i = 1; i < started; i++) pthread_join(pool->workers[i].thread, NULL);
+}
+
+int pool_threads(const WorkPool* pool) {
+    return pool->threads;
+}
+
+u64 pool_steals(const WorkPool* pool) {
+    return __atomic_load_n(&pool->steals, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,520 @@
+// src/ppu.c
+#include <string.h>
+#include "gb.h"
+#include "tile.h"
+
+// PPU
+// Los cambios de modo se programan como eventos, así que la PPU no cuesta
+// nada entre ellos. Hay dos backends para el modo 3:
+//  - FAST: cada línea se dibuja de una vez al entrar en HBlank (este fichero).
+//  - FIFO: pixel FIFO paso a paso, con modo 3 de duración variable
+//    (ppu_fifo.c). Se pone al día de forma perezosa en los eventos y antes
+//    de cada escritura en un registro de la PPU.
+//
+// Línea visible (0-143):  Modo 2 (80) -> Modo 3 (172+) -> Modo 0 (resto)
+// Líneas 144-153:         Modo 1 (VBlank)
+
+// Bits de STAT
+#define STAT_LYC_EQUAL   2
+#define STAT_INT_HBLANK  3
+#define STAT_INT_VBLANK  4
+#define STAT_INT_OAM     5
+#define STAT_INT_LYC     6
+
+// Cada píxel de la línea se compone como (paleta << 2) | color, para poder
+// aplicar las tres paletas con una única tabla de 12 entradas.
+#define PAL_BGP  0
+#define PAL_OBP0 1
+#define PAL_OBP1 2
+
+// ------------------------- Caché de tiles ------------------------------
+
+// Redecodifica todos los tiles marcados como sucios desde la última línea
+static void flush_tile_cache(GameBoy* gb) {
+    for (int i = 0; i < TILE_COUNT / 64; i++) {
+        u64 dirty = gb->ppu.tile_dirty[i];
+        while (dirty) {
+            int bit = __builtin_ctzll(dirty);
+            int tile = i * 64 + bit;
+            tile_decode_rows(&gb->bus.vram[tile * 16], &gb->ppu.tiles[tile][0][0], 8);
+            gb->ppu.tile_version[tile]++;
+            dirty &= dirty - 1;
+        }
+        gb->ppu.tile_dirty[i] = 0;
+    }
+}
+
+// ------------------------ Índice de sprites ----------------------------
+
+// Pone (set) o quita la entrada i de las líneas que cubre con Y = oam_y
+static void index_sprite(Ppu* ppu, int i, u8 oam_y, int height, bool set) {
+    int top = oam_y - 16;
+    int bottom = top + height;
+    if (top < 0) top = 0;
+    if (bottom > LCD_HEIGHT) bottom = LCD_HEIGHT;
+
+    u64 bit = 1ULL << i;
+    for (int ly = top; ly < bottom; ly++) {
+        if (set) ppu->line_sprites[ly] |= bit;
+        else     ppu->line_sprites[ly] &= ~bit;
+    }
+}
+
+// Pone al día el índice antes de usarlo
+static void update_sprite_index(GameBoy* gb, int height) {
+    Ppu* ppu = &gb->ppu;
+
+    // Cambio de tamaño de sprite: todas las entradas cambian de altura
+    if (height != ppu->sprite_height) {
+        memset(ppu->line_sprites, 0, sizeof(ppu->line_sprites));
+        ppu->sprite_dirty = ALL_SPRITES;
+        ppu->sprite_height = height;
+    }
+
+    u64 dirty = ppu->sprite_dirty;
+    while (dirty) {
+        int i = __builtin_ctzll(dirty);
+        u8 y = gb->bus.oam[i * 4];
+
+        index_sprite(ppu, i, ppu->sprite_y[i], height, false);
+        index_sprite(ppu, i, y, height, true);
+        ppu->sprite_y[i] = y;
+
+        dirty &= dirty - 1;
+    }
+    ppu->sprite_dirty = 0;
+}
+
+int ppu_select_sprites(GameBoy* gb, u8 ly, u8* selected) {
+    update_sprite_index(gb, BIT(gb->bus.io[REG_LCDC], LCDC_OBJ_SIZE) ? 16 : 8);
+
+    int count = 0;
+    u64 candidates = gb->ppu.line_sprites[ly];
+    while (candidates && count < SPRITES_PER_LINE) {
+        selected[count++] = __builtin_ctzll(candidates);
+        candidates &= candidates - 1;
+    }
+    return count;
+}
+
+// --------------------------- Renderizado -------------------------------
+
+// Dibuja el fondo o la ventana en line[] desde x_start, usando el mapa de
+// tiles map_base y la fila de píxeles y (0-255) de ese mapa.
+static void render_tilemap(GameBoy* gb, u8* line, int x_start, u16 map_base, u8 y, u8 scroll_x) {
+    u8 lcdc = gb->bus.io[REG_LCDC];
+    const u8* map = &gb->bus.vram[map_base - 0x8000 + (y / 8) * 32];
+    u8 tile_y = y & 7;
+
+    int x = x_start;
+    u8 map_x = scroll_x;
+    while (x < LCD_WIDTH) {
+        const u8* row = gb->ppu.tiles[ppu_tile_index(lcdc, map[(map_x / 8) & 31])][tile_y];
+
+        // Copiamos el tramo de la fila que cae dentro de este tile
+        int offset = map_x & 7;
+        int count = 8 - offset;
+        if (count > LCD_WIDTH - x) count = LCD_WIDTH - x;
+        memcpy(&line[x], &row[offset], count);
+
+        x += count;
+        map_x += count;
+    }
+}
+
+// Dibuja los sprites de la línea ly encima de line[]
+static void render_sprites(GameBoy* gb, u8* line, u8 ly) {
+    u8 lcdc = gb->bus.io[REG_LCDC];
+    int height = BIT(lcdc, LCDC_OBJ_SIZE) ? 16 : 8;
+
+    // 1. Selección: los 10 primeros sprites de la OAM que tocan la línea
+    u8 selected[SPRITES_PER_LINE];
+    int count = ppu_select_sprites(gb, ly, selected);
+
+    // 2. Prioridad (DMG): gana la X menor y, a igualdad, el índice menor.
+    // Ordenamos por X (la ordenación es estable, respeta el índice).
+    for (int i = 1; i < count; i++) {
+        u8 s = selected[i];
+        int j = i - 1;
+        while (j >= 0 && gb->bus.oam[selected[j] * 4 + 1] > gb->bus.oam[s * 4 + 1]) {
+            selected[j + 1] = selected[j];
+            j--;
+        }
+        selected[j + 1] = s;
+    }
+
+    // 3. Dibujado, del más prioritario al menos. Cada píxel lo reclama el
+    // primer sprite opaco que lo cubre, aunque luego quede detrás del fondo.
+    bool claimed[LCD_WIDTH] = { false };
+
+    for (int i = 0; i < count; i++) {
+        const u8* obj = &gb->bus.oam[selected[i] * 4];
+        int x = obj[1] - 8;
+        u8 attr = obj[3];
+
+        int row = ly - (obj[0] - 16);
+        if (BIT(attr, OBJ_FLIP_Y)) row = height - 1 - row;
+
+        // En modo 8x16 el bit 0 del número de tile se ignora
+        u8 tile = obj[2];
+        if (height == 16) tile &= 0xFE;
+        const u8* pixels = gb->ppu.tiles[tile + row / 8][row & 7];
+
+        u8 palette = BIT(attr, OBJ_PALETTE) ? PAL_OBP1 : PAL_OBP0;
+
+        for (int px = 0; px < 8; px++) {
+            int sx = x + px;
+            if (sx < 0 || sx >= LCD_WIDTH || claimed[sx]) continue;
+
+            u8 color = pixels[BIT(attr, OBJ_FLIP_X) ? 7 - px : px];
+            if (color == 0) continue; // Transparente
+            claimed[sx] = true;
+
+            // Detrás del fondo: solo se ve sobre el color 0 del fondo
+            if (BIT(attr, OBJ_BEHIND_BG) && (line[sx] & 3) != 0) continue;
+
+            line[sx] = (palette << 2) | color;
+        }
+    }
+}
+
+// ¿Se ve la ventana en la línea ly?
+static bool window_visible(GameBoy* gb, u8 ly) {
+    u8* io = gb->bus.io;
+    return BIT(io[REG_LCDC], LCDC_BG_ENABLE) && BIT(io[REG_LCDC], LCDC_WIN_ENABLE)
+        && ly >= io[REG_WY] && io[REG_WX] < LCD_WIDTH + 7;
+}
+
+// ------------------------- Caché de líneas -----------------------------
+
+static inline u64 hash_mix(u64 h, u64 v) {
+    h = (h ^ v) * 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 29);
+}
+
+// Añade al hash los tiles (número y versión) de count columnas de una fila
+// del mapa. La versión sale de la caché de tiles, que a su vez solo se
+// invalida desde bus_write: no hace falta mirar los datos de los tiles.
+static u64 hash_tilemap_row(GameBoy* gb, u64 h, u16 map_base, u8 y, u8 first_column, int count) {
+    u8 lcdc = gb->bus.io[REG_LCDC];
+    const u8* map = &gb->bus.vram[map_base - 0x8000 + (y / 8) * 32];
+
+    for (int i = 0; i < count; i++) {
+        int tile = ppu_tile_index(lcdc, map[(first_column + i) & 31]);
+        h = hash_mix(h, (u64)tile << 32 | gb->ppu.tile_version[tile]);
+    }
+    return h;
+}
+
+// Hash de todo lo que determina la línea ly: registros, tiles del fondo y la
+// ventana, y los sprites de la línea. Nunca devuelve 0.
+static u64 line_hash(GameBoy* gb, u8 ly) {
+    u8* io = gb->bus.io;
+    u8 lcdc = io[REG_LCDC];
+    u8 y = ly + io[REG_SCY];
+
+    u64 h = hash_mix(0, (u64)lcdc | (u64)io[REG_BGP] << 8 | (u64)io[REG_OBP0] << 16
+                        | (u64)io[REG_OBP1] << 24 | (u64)io[REG_SCX] << 32 | (u64)y << 40);
+
+    if (BIT(lcdc, LCDC_BG_ENABLE)) {
+        u16 map = BIT(lcdc, LCDC_BG_MAP) ? 0x9C00 : 0x9800;
+        h = hash_tilemap_row(gb, h, map, y, io[REG_SCX] / 8, LCD_WIDTH / 8 + 1);
+    }
+
+    if (window_visible(gb, ly)) {
+        int wx = io[REG_WX] - 7;
+        int x_start = wx < 0 ? 0 : wx;
+        u16 map = BIT(lcdc, LCDC_WIN_MAP) ? 0x9C00 : 0x9800;
+        h = hash_mix(h, (u64)io[REG_WX] << 8 | gb->ppu.window_line);
+        h = hash_tilemap_row(gb, h, map, gb->ppu.window_line, 0, (LCD_WIDTH - x_start) / 8 + 2);
+    }
+
+    if (BIT(lcdc, LCDC_OBJ_ENABLE)) {
+        u8 selected[SPRITES_PER_LINE];
+        int count = ppu_select_sprites(gb, ly, selected);
+        for (int i = 0; i < count; i++) {
+            const u8* obj = &gb->bus.oam[selected[i] * 4];
+            u8 tile = obj[2];
+            if (BIT(lcdc, LCDC_OBJ_SIZE)) tile &= 0xFE;
+
+            u32 entry;
+            memcpy(&entry, obj, sizeof(entry));
+            h = hash_mix(h, (u64)entry << 32 | gb->ppu.tile_version[tile]);
+            if (BIT(lcdc, LCDC_OBJ_SIZE)) h = hash_mix(h, gb->ppu.tile_version[tile + 1]);
+        }
+    }
+
+    return h | 1;
+}
+
+// Dibuja la línea LY completa en el framebuffer
+static void render_line(GameBoy* gb) {
+    u8* io = gb->bus.io;
+    u8 lcdc = io[REG_LCDC];
+    u8 ly = io[REG_LY];
+
+    // Frame saltado: solo llevamos la cuenta de líneas de la ventana
+    if (!gb->ppu.render_frame) {
+        if (window_visible(gb, ly)) gb->ppu.window_line++;
+        return;
+    }
+
+    flush_tile_cache(gb);
+
+    // Si nada de lo que determina la línea ha cambiado desde el último frame
+    // publicado, la copiamos de ese frame
+    if (gb->ppu.line_cache) {
+        u64 hash = line_hash(gb, ly);
+        gb->ppu.line_hash_next[ly] = hash;
+        if (hash == gb->ppu.line_hash[ly]) {
+            memcpy(fb_back_line(&gb->fb, ly), fb_last_line(&gb->fb, ly), FB_LINE_BYTES);
+            gb->ppu.line_cache_hits++;
+            if (window_visible(gb, ly)) gb->ppu.window_line++;
+            return;
+        }
+        gb->ppu.line_cache_misses++;
+    }
+
+    u8 line[LCD_WIDTH];
+
+    // Fondo
+    if (BIT(lcdc, LCDC_BG_ENABLE)) {
+        u16 map = BIT(lcdc, LCDC_BG_MAP) ? 0x9C00 : 0x9800;
+        render_tilemap(gb, line, 0, map, ly + io[REG_SCY], io[REG_SCX]);
+    }
+    else {
+        memset(line, 0, sizeof(line));
+    }
+
+    // Ventana
+    if (window_visible(gb, ly)) {
+        int wx = io[REG_WX] - 7;
+        u16 map = BIT(lcdc, LCDC_WIN_MAP) ? 0x9C00 : 0x9800;
+        int x_start = wx < 0 ? 0 : wx;
+        render_tilemap(gb, line, x_start, map, gb->ppu.window_line, x_start - wx);
+        gb->ppu.window_line++;
+    }
+
+    // Sprites
+    if (BIT(lcdc, LCDC_OBJ_ENABLE)) {
+        render_sprites(gb, line, ly);
+    }
+
+    // Paletas: tabla con los tonos de BGP, OBP0 y OBP1
+    u8 shades[16] = { 0 };
+    for (int i = 0; i < 4; i++) {
+        shades[(PAL_BGP << 2) | i]  = (io[REG_BGP]  >> (i * 2)) & 3;
+        shades[(PAL_OBP0 << 2) | i] = (io[REG_OBP0] >> (i * 2)) & 3;
+        shades[(PAL_OBP1 << 2) | i] = (io[REG_OBP1] >> (i * 2)) & 3;
+    }
+
+    tile_map_pack(line, fb_back_line(&gb->fb, ly), shades, LCD_WIDTH);
+}
+
+// ------------------------- Registros y STAT ----------------------------
+
+// Actualiza STAT (modo y coincidencia LY=LYC) y pide la interrupción
+// LCD_STAT en el flanco de subida de la línea interna.
+static void update_stat(GameBoy* gb) {
+    u8* io = gb->bus.io;
+    u8 stat = (io[REG_STAT] & 0x78) | 0x80 | gb->ppu.mode;
+
+    if (io[REG_LY] == io[REG_LYC]) SET_BIT(stat, STAT_LYC_EQUAL);
+    io[REG_STAT] = stat;
+
+    bool line = false;
+    if (BIT(io[REG_LCDC], LCDC_LCD_ENABLE)) {
+        line = (BIT(stat, STAT_INT_LYC) && BIT(stat, STAT_LYC_EQUAL))
+            || (BIT(stat, STAT_INT_HBLANK) && gb->ppu.mode == PPU_MODE_HBLANK)
+            || (BIT(stat, STAT_INT_VBLANK) && gb->ppu.mode == PPU_MODE_VBLANK)
+            || (BIT(stat, STAT_INT_OAM) && gb->ppu.mode == PPU_MODE_OAM);
+    }
+
+    if (line && !gb->ppu.stat_line) {
+        cpu_request_interrupt(gb, INT_LCD_STAT);
+    }
+    gb->ppu.stat_line = line;
+}
+
+static void set_mode(GameBoy* gb, PpuMode mode) {
+    gb->ppu.mode = mode;
+    update_stat(gb);
+}
+
+// Decide al empezar cada frame si se van a producir sus píxeles
+static bool should_render(GameBoy* gb) {
+    Ppu* ppu = &gb->ppu;
+
+    switch (ppu->render_policy) {
+        case PPU_RENDER_EVERY_N:
+            return ppu->render_interval <= 1 || ppu->frame_count % ppu->render_interval == 0;
+        case PPU_RENDER_ON_DEMAND:
+            if (!ppu->render_request) return false;
+            ppu->render_request = false;
+            return true;
+        case PPU_RENDER_NEVER:
+            return false;
+        default:
+            return true;
+    }
+}
+
+// Empieza la línea LY en el instante when
+static void start_line(GameBoy* gb, u64 when) {
+    gb->ppu.line_start = when;
+
+    if (gb->bus.io[REG_LY] == 0) {
+        gb->ppu.render_frame = should_render(gb);
+    }
+
+    if (gb->bus.io[REG_LY] < LCD_HEIGHT) {
+        set_mode(gb, PPU_MODE_OAM);
+        sched_schedule(gb, EVENT_PPU, when + MODE2_TICKS);
+    }
+    else {
+        if (gb->bus.io[REG_LY] == LCD_HEIGHT) {
+            set_mode(gb, PPU_MODE_VBLANK);
+            cpu_request_interrupt(gb, INT_VBLANK);
+            gb->ppu.frame_count++;
+            // Frame dibujado entero: se entrega a los consumidores
+            if (gb->ppu.render_frame) {
+                fb_publish(&gb->fb, gb->ppu.frame_count);
+                memcpy(gb->ppu.line_hash, gb->ppu.line_hash_next, sizeof(gb->ppu.line_hash));
+            }
+        }
+        else {
+            update_stat(gb); // Solo cambia LY
+        }
+        sched_schedule(gb, EVENT_PPU, when + LINE_TICKS);
+    }
+}
+
+void ppu_init(GameBoy* gb, PpuBackend backend) {
+    u8* io = gb->bus.io;
+    gb->ppu.backend = backend;
+
+    // Kernels SIMD según la CPU (la elección es la misma para todas las instancias)
+    tile_init();
+
+    // Valores tras la boot ROM
+    io[REG_LCDC] = 0x91;
+    io[REG_STAT] = 0x85;
+    io[REG_BGP]  = 0xFC;
+    io[REG_OBP0] = 0xFF;
+    io[REG_OBP1] = 0xFF;
+
+    // La caché se reconstruye entera en la primera línea
+    memset(gb->ppu.tile_dirty, 0xFF, sizeof(gb->ppu.tile_dirty));
+    ppu_set_line_cache(gb, true);
+
+    io[REG_LY] = 0;
+    gb->ppu.window_line = 0;
+    start_line(gb, gb->ticks);
+}
+
+void ppu_set_render_policy(GameBoy* gb, PpuRenderPolicy policy, u32 interval) {
+    gb->ppu.render_policy = policy;
+    gb->ppu.render_interval = interval;
+}
+
+void ppu_set_line_cache(GameBoy* gb, bool enabled) {
+    // Solo el backend FAST dibuja líneas enteras de una vez
+    gb->ppu.line_cache = enabled && gb->ppu.backend == PPU_BACKEND_FAST;
+    memset(gb->ppu.line_hash, 0, sizeof(gb->ppu.line_hash));
+    memset(gb->ppu.line_hash_next, 0, sizeof(gb->ppu.line_hash_next));
+}
+
+void ppu_invalidate_caches(GameBoy* gb) {
+    memset(gb->ppu.tile_dirty, 0xFF, sizeof(gb->ppu.tile_dirty));
+    gb->ppu.sprite_height = 0;
+    memset(gb->ppu.line_hash, 0, sizeof(gb->ppu.line_hash));
+    memset(gb->ppu.line_hash_next, 0, sizeof(gb->ppu.line_hash_next));
+}
+
+void ppu_request_frame(GameBoy* gb) {
+    gb->ppu.render_request = true;
+}
+
+void ppu_write_lcdc(GameBoy* gb, u8 value) {
+    u8* io = gb->bus.io;
+    bool was_on = BIT(io[REG_LCDC], LCDC_LCD_ENABLE);
+    bool is_on = BIT(value, LCDC_LCD_ENABLE);
+    io[REG_LCDC] = value;
+
+    if (was_on && !is_on) {
+        // Apagado: LY se queda a 0, modo 0 y la PPU deja de programar eventos
+        sched_cancel(gb, EVENT_PPU);
+        io[REG_LY] = 0;
+        set_mode(gb, PPU_MODE_HBLANK);
+    }
+    else if (!was_on && is_on) {
+        // Encendido: empieza un frame nuevo en la línea 0
+        io[REG_LY] = 0;
+        gb->ppu.window_line = 0;
+        start_line(gb, gb->ticks);
+    }
+}
+
+void ppu_write_stat(GameBoy* gb, u8 value) {
+    // Solo los bits 3-6 son escribibles
+    gb->bus.io[REG_STAT] = (gb->bus.io[REG_STAT] & 0x87) | (value & 0x78);
+    update_stat(gb);
+}
+
+void ppu_write_lyc(GameBoy* gb, u8 value) {
+    gb->bus.io[REG_LYC] = value;
+    update_stat(gb);
+}
+
+void ppu_sync(GameBoy* gb) {
+    if (gb->ppu.backend != PPU_BACKEND_FIFO || gb->ppu.mode != PPU_MODE_DRAW) return;
+
+    // Si la línea se completa aquí, adelantamos el paso a HBlank
+    if (!gb->ppu.fifo.done && ppu_fifo_run(gb)) {
+        sched_schedule(gb, EVENT_PPU, gb->ticks);
+    }
+}
+
+void ppu_event(GameBoy* gb) {
+    u8* io = gb->bus.io;
+
+    switch (gb->ppu.mode) {
+        case PPU_MODE_OAM:
+            // Fin de la búsqueda en OAM: empieza el dibujado
+            set_mode(gb, PPU_MODE_DRAW);
+            if (gb->ppu.backend == PPU_BACKEND_FIFO) {
+                ppu_fifo_start(gb);
+            }
+            // El modo 3 dura como mínimo MODE3_TICKS
+            sched_schedule(gb, EVENT_PPU, gb->ppu.line_start + MODE2_TICKS + MODE3_TICKS);
+            break;
+
+        case PPU_MODE_DRAW:
+            if (gb->ppu.backend == PPU_BACKEND_FIFO) {
+                // Aún faltan píxeles: volvemos cuando, como pronto, estén todos
+                if (!gb->ppu.fifo.done && !ppu_fifo_run(gb)) {
+                    int remaining = LCD_WIDTH - gb->ppu.fifo.lx;
+                    sched_schedule(gb, EVENT_PPU, gb->ppu.fifo.tick + remaining);
+                    break;
+                }
+            }
+            else {
+                // Fin del dibujado: la línea se pinta de una vez
+                render_line(gb);
+            }
+            set_mode(gb, PPU_MODE_HBLANK);
+            sched_schedule(gb, EVENT_PPU, gb->ppu.line_start + LINE_TICKS);
+            break;
+
+        case PPU_MODE_HBLANK:
+        case PPU_MODE_VBLANK:
+            // Fin de línea
+            io[REG_LY]++;
+            if (io[REG_LY] == LINES_PER_FRAME) {
+                io[REG_LY] = 0;
+                gb->ppu.window_line = 0;
+            }
+            start_line(gb, gb->ppu.line_start + LINE_TICKS);
+            break;
+    }
+}
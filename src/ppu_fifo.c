@@ -0,0 +1,324 @@
+// src/ppu_fifo.c
+#include <string.h>
+#include "gb.h"
+#include "tile.h"
+
+// Backend pixel FIFO
+// Simula el modo 3 un dot (T-Cycle) cada vez, como el hardware:
+//  - Un fetcher lee del mapa y de los datos de tile (2 dots por paso) y
+//    vuelca 8 píxeles en el FIFO del fondo cuando está vacío.
+//  - El shifter saca un píxel por dot, descartando antes SCX & 7.
+//  - Al llegar a la X de un sprite, todo se detiene mientras se busca
+//    (6 dots, más lo que le falte al fetcher para terminar su tile).
+//  - Al llegar a WX - 7, el FIFO se vacía y el fetcher pasa a la ventana.
+// La duración del modo 3 sale sola: 172 dots + SCX & 7 + sprites + ventana.
+// Los registros (SCX, BGP...) se leen en el dot en que se usan, así que los
+// cambios a mitad de línea se ven donde toca.
+
+// Dots de la primera búsqueda de tile, que el hardware descarta
+#define FIFO_STARTUP_DOTS 6
+
+// Dots fijos de la búsqueda de un sprite
+#define SPRITE_FETCH_DOTS 6
+
+// Bits de cada entrada del FIFO de sprites
+#define OBJ_PIXEL_PALETTE 0x04
+#define OBJ_PIXEL_BEHIND  0x08
+
+// ------------------------------ Fetcher --------------------------------
+
+// Fila de píxeles (0-255) del mapa que está leyendo el fetcher
+static u8 fetch_row(GameBoy* gb) {
+    PpuFifo* f = &gb->ppu.fifo;
+    if (f->window) return gb->ppu.window_line;
+    return gb->bus.io[REG_LY] + gb->bus.io[REG_SCY];
+}
+
+static void fetcher_step(GameBoy* gb) {
+    PpuFifo* f = &gb->ppu.fifo;
+    u8* io = gb->bus.io;
+    u8 lcdc = io[REG_LCDC];
+
+    switch (f->fetch_step) {
+        case 0: { // Número de tile
+            u8 y = fetch_row(gb);
+            u16 map;
+            u8 column;
+            if (f->window) {
+                map = BIT(lcdc, LCDC_WIN_MAP) ? 0x9C00 : 0x9800;
+                column = f->fetch_x & 31;
+            }
+            else {
+                map = BIT(lcdc, LCDC_BG_MAP) ? 0x9C00 : 0x9800;
+                column = ((io[REG_SCX] >> 3) + f->fetch_x) & 31;
+            }
+            f->tile_no = gb->bus.vram[map - 0x8000 + (y / 8) * 32 + column];
+            f->fetch_step++;
+            break;
+        }
+        case 2: // Plano bajo
+        case 4: { // Plano alto
+            u8 y = fetch_row(gb);
+            u16 addr = ppu_tile_index(lcdc, f->tile_no) * 16 + (y & 7) * 2;
+            f->data[f->fetch_step == 2 ? 0 : 1] = gb->bus.vram[addr + (f->fetch_step == 2 ? 0 : 1)];
+            f->fetch_step++;
+            break;
+        }
+        case 6: // Volcado: solo si el FIFO está vacío
+            if (f->bg_count == 0) {
+                tile_decode_rows(f->data, f->bg, 1);
+                f->bg_head = 0;
+                f->bg_count = 8;
+                f->fetch_x++;
+                f->fetch_step = 0;
+            }
+            break;
+        default: // Segundo dot de cada paso
+            f->fetch_step++;
+            break;
+    }
+}
+
+// ------------------------------ Sprites --------------------------------
+
+// Mezcla en el FIFO de sprites la fila del sprite i de la OAM. Una posición
+// ya ocupada (color != 0) no se pisa: el sprite anterior tiene prioridad.
+static void fetch_sprite(GameBoy* gb, int i) {
+    PpuFifo* f = &gb->ppu.fifo;
+    const u8* obj = &gb->bus.oam[i * 4];
+    u8 ly = gb->bus.io[REG_LY];
+    int height = BIT(gb->bus.io[REG_LCDC], LCDC_OBJ_SIZE) ? 16 : 8;
+    u8 attr = obj[3];
+
+    int row = ly - (obj[0] - 16);
+    if (BIT(attr, OBJ_FLIP_Y)) row = height - 1 - row;
+
+    u8 tile = obj[2];
+    if (height == 16) tile &= 0xFE;
+    u16 addr = (tile + row / 8) * 16 + (row & 7) * 2;
+
+    u8 pixels[8];
+    tile_decode_rows(&gb->bus.vram[addr], pixels, 1);
+
+    u8 flags = (BIT(attr, OBJ_PALETTE) ? OBJ_PIXEL_PALETTE : 0)
+             | (BIT(attr, OBJ_BEHIND_BG) ? OBJ_PIXEL_BEHIND : 0);
+
+    for (int px = 0; px < 8; px++) {
+        // Posición en el FIFO: 0 es el próximo píxel que sale (lx)
+        int slot = obj[1] - 8 + px - f->lx;
+        if (slot < 0 || slot >= 8 || (f->obj[slot] & 3)) continue;
+
+        u8 color = pixels[BIT(attr, OBJ_FLIP_X) ? 7 - px : px];
+        if (color) f->obj[slot] = color | flags;
+    }
+}
+
+// Busca un sprite pendiente que empiece en el píxel actual. Si lo hay,
+// devuelve la penalización en dots (y lo mezcla); si no, 0.
+static int check_sprites(GameBoy* gb) {
+    PpuFifo* f = &gb->ppu.fifo;
+    if (!BIT(gb->bus.io[REG_LCDC], LCDC_OBJ_ENABLE)) return 0;
+
+    // Los sprites con X < 8 asoman por la izquierda: todos empiezan en
+    // lx = 0, pero el contador del hardware pasa antes por la X menor.
+    int best = -1;
+    int best_x = 0;
+    for (int s = 0; s < f->sprite_count; s++) {
+        if (f->sprites_done & (1 << s)) continue;
+
+        int x = gb->bus.oam[f->sprites[s] * 4 + 1];
+        if (x >= LCD_WIDTH + 8 || x > f->lx + 8) continue;
+        if (best < 0 || x < best_x) {
+            best = s;
+            best_x = x;
+        }
+    }
+    if (best < 0) return 0;
+
+    f->sprites_done |= 1 << best;
+    fetch_sprite(gb, f->sprites[best]);
+
+    // El fetcher del fondo termina antes su tile (hasta 5 dots)
+    int wait = f->fetch_step < 5 ? 5 - f->fetch_step : 0;
+    return SPRITE_FETCH_DOTS + wait;
+}
+
+// ------------------------------ Shifter --------------------------------
+
+static void output_pixel(GameBoy* gb, u8 bg_color) {
+    PpuFifo* f = &gb->ppu.fifo;
+    u8* io = gb->bus.io;
+
+    // En un frame saltado el FIFO corre igual (la duración del modo 3 no
+    // cambia), pero no se produce el píxel
+    if (gb->ppu.render_frame) {
+        if (!BIT(io[REG_LCDC], LCDC_BG_ENABLE)) bg_color = 0;
+
+        u8 obj = f->obj[0];
+        u8 shade;
+        if ((obj & 3) && !((obj & OBJ_PIXEL_BEHIND) && bg_color)) {
+            u8 palette = (obj & OBJ_PIXEL_PALETTE) ? io[REG_OBP1] : io[REG_OBP0];
+            shade = (palette >> ((obj & 3) * 2)) & 3;
+        }
+        else {
+            shade = (io[REG_BGP] >> (bg_color * 2)) & 3;
+        }
+        fb_line_set(fb_back_line(&gb->fb, io[REG_LY]), f->lx, shade);
+    }
+
+    // El FIFO de sprites avanza con la salida
+    memmove(&f->obj[0], &f->obj[1], 7);
+    f->obj[7] = 0;
+    f->lx++;
+}
+
+// ¿Empieza la ventana en este píxel?
+static bool window_starts(GameBoy* gb) {
+    PpuFifo* f = &gb->ppu.fifo;
+    u8* io = gb->bus.io;
+
+    if (f->window) return false;
+    if (!BIT(io[REG_LCDC], LCDC_WIN_ENABLE) || !BIT(io[REG_LCDC], LCDC_BG_ENABLE)) return false;
+    if (io[REG_LY] < io[REG_WY]) return false;
+
+    int wx = io[REG_WX] - 7;
+    return wx < LCD_WIDTH && f->lx >= (wx < 0 ? 0 : wx);
+}
+
+// Un dot del modo 3
+static void fifo_dot(GameBoy* gb) {
+    PpuFifo* f = &gb->ppu.fifo;
+
+    if (f->startup) {
+        f->startup--;
+        return;
+    }
+    if (f->stall) {
+        f->stall--;
+        return;
+    }
+
+    if (window_starts(gb)) {
+        // El fetcher vuelve a empezar, ahora en la ventana
+        int wx = gb->bus.io[REG_WX] - 7;
+        f->window = true;
+        f->bg_count = 0;
+        f->fetch_step = 0;
+        f->fetch_x = 0;
+        f->discard = wx < 0 ? -wx : 0;
+    }
+
+    fetcher_step(gb);
+
+    if (f->bg_count == 0) return;
+
+    // Mientras se descarta no avanza la X de salida (ni los sprites)
+    if (f->discard) {
+        f->bg_head++;
+        f->bg_count--;
+        f->discard--;
+        return;
+    }
+
+    int penalty = check_sprites(gb);
+    if (penalty) {
+        f->stall = penalty - 1;
+        return;
+    }
+
+    u8 color = f->bg[f->bg_head++];
+    f->bg_count--;
+    output_pixel(gb, color);
+}
+
+// ------------------------- Frames saltados -----------------------------
+
+// Dots seguidos, desde el actual, en los que solo avanzan el fetcher y el
+// shifter: sin descartar, sin que empiece la ventana, sin sprites y sin que
+// se vacíe el FIFO del fondo. 0 si el dot actual necesita fifo_dot.
+static int steady_dots(GameBoy* gb) {
+    PpuFifo* f = &gb->ppu.fifo;
+    u8* io = gb->bus.io;
+    if (f->startup || f->stall || f->discard || f->bg_count == 0) return 0;
+
+    int n = f->bg_count;
+    if (LCD_WIDTH - f->lx < n) n = LCD_WIDTH - f->lx;
+
+    if (!f->window && BIT(io[REG_LCDC], LCDC_WIN_ENABLE) && BIT(io[REG_LCDC], LCDC_BG_ENABLE)
+        && io[REG_LY] >= io[REG_WY]) {
+        int wx = io[REG_WX] - 7;
+        if (wx < LCD_WIDTH && (wx < 0 ? 0 : wx) - f->lx < n) n = (wx < 0 ? 0 : wx) - f->lx;
+    }
+
+    if (BIT(io[REG_LCDC], LCDC_OBJ_ENABLE)) {
+        for (int s = 0; s < f->sprite_count; s++) {
+            if (f->sprites_done & (1 << s)) continue;
+            int x = gb->bus.oam[f->sprites[s] * 4 + 1];
+            if (x < LCD_WIDTH + 8 && x - 8 - f->lx < n) n = x - 8 - f->lx;
+        }
+    }
+    return n > 0 ? n : 0;
+}
+
+// n dots de steady_dots de una vez. El estado queda igual que con fifo_dot,
+// salvo que no se produce ningún píxel (solo vale en frames saltados).
+static void skip_dots(GameBoy* gb, int n) {
+    PpuFifo* f = &gb->ppu.fifo;
+
+    // El fetcher solo hace algo hasta llegar a esperar en el paso 6
+    for (int i = 0; i < n && f->fetch_step < 6; i++) fetcher_step(gb);
+
+    f->bg_head += n;
+    f->bg_count -= n;
+    memmove(&f->obj[0], &f->obj[n], 8 - n);
+    memset(&f->obj[8 - n], 0, n);
+    f->lx += n;
+}
+
+// ---------------------------- Interfaz ---------------------------------
+
+void ppu_fifo_start(GameBoy* gb) {
+    PpuFifo* f = &gb->ppu.fifo;
+    memset(f, 0, sizeof(*f));
+
+    f->tick = gb->ppu.line_start + MODE2_TICKS;
+    f->startup = FIFO_STARTUP_DOTS;
+    f->discard = gb->bus.io[REG_SCX] & 7;
+    f->sprite_count = ppu_select_sprites(gb, gb->bus.io[REG_LY], f->sprites);
+}
+
+bool ppu_fifo_run(GameBoy* gb) {
+    PpuFifo* f = &gb->ppu.fifo;
+
+    while (!f->done && f->tick < gb->ticks) {
+        // Las esperas (arranque y sprites) no hacen nada: van de una vez
+        u64 left = gb->ticks - f->tick;
+        u8* wait = f->startup ? &f->startup : &f->stall;
+        if (*wait) {
+            u8 n = *wait < left ? *wait : (u8)left;
+            *wait -= n;
+            f->tick += n;
+            continue;
+        }
+
+        // En un frame saltado solo importa cuánto dura el modo 3: los
+        // tramos en los que no hay nada que decidir también van de una vez
+        int n = gb->ppu.render_frame ? 0 : steady_dots(gb);
+        if (n > 1) {
+            if ((u64)n > left) n = (int)left;
+            skip_dots(gb, n);
+            f->tick += n;
+        }
+        else {
+            fifo_dot(gb);
+            f->tick++;
+        }
+
+        if (f->lx == LCD_WIDTH) {
+            f->done = true;
+            f->end_tick = f->tick;
+            if (f->window) gb->ppu.window_line++;
+        }
+    }
+    return f->done;
+}
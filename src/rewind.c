@@ -0,0 +1,229 @@
+// src/rewind.c
+#include <stdlib.h>
+#include <string.h>
+#include "gb.h"
+#include "state.h"
+#include "rewind.h"
+
+// Un literal termina al encontrar tantos bytes iguales seguidos (más cortos
+// no compensan la cabecera de un bloque nuevo)
+#define RLE_MIN_ZEROS 8
+
+// Cabecera de un bloque en el peor caso: dos varints de 32 bits
+#define RLE_BLOCK_HEADER 10
+
+// Memoria por defecto por frame, como fracción del estado completo
+#define REWIND_DEFAULT_FRACTION 16
+
+// ------------------------------ Codec ----------------------------------
+
+static size_t put_varint(u8* out, size_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = (u8)(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = (u8)value;
+    return n;
+}
+
+static size_t get_varint(const u8* in, size_t* value) {
+    size_t n = 0;
+    size_t v = 0;
+    int shift = 0;
+    do {
+        v |= (size_t)(in[n] & 0x7F) << shift;
+        shift += 7;
+    } while (in[n++] & 0x80);
+    *value = v;
+    return n;
+}
+
+// Bytes iguales desde i (de 8 en 8 mientras se pueda)
+static size_t equal_run(const u8* a, const u8* b, size_t i, size_t size) {
+    size_t start = i;
+    while (i + 8 <= size) {
+        u64 x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        if (x != y) break;
+        i += 8;
+    }
+    while (i < size && a[i] == b[i]) i++;
+    return i - start;
+}
+
+// Peor caso de rle_encode: todo literales, cortados por rachas de ceros
+static size_t rle_bound(size_t size) {
+    return size + (size / RLE_MIN_ZEROS + 1) * RLE_BLOCK_HEADER;
+}
+
+// Comprime el XOR de a y b. Devuelve los bytes escritos en out.
+static size_t rle_encode(const u8* a, const u8* b, size_t size, u8* out) {
+    size_t n = 0;
+    size_t i = 0;
+    while (i < size) {
+        size_t zeros = equal_run(a, b, i, size);
+        i += zeros;
+        if (i == size) break;
+
+        // Literales hasta la próxima racha larga de bytes iguales
+        size_t start = i;
+        while (i < size) {
+            if (a[i] != b[i]) {
+                i++;
+                continue;
+            }
+            size_t run = equal_run(a, b, i, size);
+            if (run >= RLE_MIN_ZEROS || i + run == size) break;
+            i += run;
+        }
+
+        n += put_varint(out + n, zeros);
+        n += put_varint(out + n, i - start);
+        for (size_t k = start; k < i; k++) out[n++] = a[k] ^ b[k];
+    }
+    return n;
+}
+
+// Aplica (XOR) una diferencia comprimida sobre state
+static void rle_apply(u8* state, const u8* in, size_t size) {
+    size_t pos = 0;
+    size_t n = 0;
+    while (n < size) {
+        size_t zeros, literals;
+        n += get_varint(in + n, &zeros);
+        n += get_varint(in + n, &literals);
+        pos += zeros;
+        for (size_t k = 0; k < literals; k++) state[pos++] ^= in[n++];
+    }
+}
+
+// ------------------------------ Anillo ---------------------------------
+
+static RewindEntry* entry_at(Rewind* rw, u32 i) {
+    return &rw->entries[(rw->first + i) % rw->capacity];
+}
+
+static void drop_oldest(Rewind* rw) {
+    rw->used -= entry_at(rw, 0)->size;
+    rw->first = (rw->first + 1) % rw->capacity;
+    rw->count--;
+    if (rw->count == 0) rw->write = 0;
+}
+
+// Reserva size bytes tras la diferencia más reciente, descartando las más
+// antiguas que estorben. Devuelve false si no cabe ni con el anillo vacío.
+static bool reserve(Rewind* rw, size_t size, size_t* offset) {
+    if (size > rw->data_size) {
+        while (rw->count) drop_oldest(rw);
+        return false;
+    }
+
+    if (rw->count == rw->capacity) drop_oldest(rw);
+
+    // Si no cabe al final se vuelve al principio: lo que haya tras write es
+    // lo más antiguo y se descarta
+    size_t pos = rw->write;
+    if (pos + size > rw->data_size) {
+        while (rw->count && entry_at(rw, 0)->offset >= pos) drop_oldest(rw);
+        pos = 0;
+    }
+
+    // Las diferencias están en orden tras pos: las que se pisan son
+    // siempre las más antiguas
+    while (rw->count) {
+        RewindEntry* oldest = entry_at(rw, 0);
+        if (oldest->offset >= pos + size || pos >= oldest->offset + oldest->size) break;
+        drop_oldest(rw);
+    }
+    if (rw->count == 0) pos = 0;
+
+    *offset = pos;
+    return true;
+}
+
+// ------------------------------ Interfaz -------------------------------
+
+bool rewind_init(Rewind* rw, const GameBoy* gb, u32 frames, size_t bytes) {
+    memset(rw, 0, sizeof(*rw));
+    if (frames == 0) return false;
+
+    rw->state_size = gb_state_size(gb);
+    rw->capacity = frames;
+    rw->data_size = bytes ? bytes : rw->state_size / REWIND_DEFAULT_FRACTION * frames;
+
+    rw->head = malloc(rw->state_size);
+    rw->current = malloc(rw->state_size);
+    rw->scratch = malloc(rle_bound(rw->state_size));
+    rw->entries = malloc(sizeof(RewindEntry) * frames);
+    rw->data = malloc(rw->data_size);
+    if (!rw->head || !rw->current || !rw->scratch || !rw->entries || !rw->data) {
+        rewind_free(rw);
+        return false;
+    }
+    return true;
+}
+
+void rewind_free(Rewind* rw) {
+    free(rw->head);
+    free(rw->current);
+    free(rw->scratch);
+    free(rw->entries);
+    free(rw->data);
+    memset(rw, 0, sizeof(*rw));
+}
+
+void rewind_push(Rewind* rw, GameBoy* gb) {
+    if (!rw->has_head) {
+        // El primero, entero (y current igual, para poder actualizarlo)
+        if (!gb_save_state(gb, rw->head, rw->state_size)) return;
+        memcpy(rw->current, rw->head, rw->state_size);
+        memset(rw->last_dirty, 0, sizeof(rw->last_dirty));
+        bus_clear_dirty(&gb->bus);
+        rw->has_head = true;
+        return;
+    }
+
+    // current va un estado por detrás de head: hay que copiar lo que cambió
+    // en los dos últimos frames
+    u64 pages[BUS_DIRTY_WORDS];
+    for (int i = 0; i < BUS_DIRTY_WORDS; i++) pages[i] = rw->last_dirty[i] | gb->bus.dirty[i];
+    if (!gb_update_state(gb, rw->current, rw->state_size, pages)) return;
+    memcpy(rw->last_dirty, gb->bus.dirty, sizeof(rw->last_dirty));
+    bus_clear_dirty(&gb->bus);
+
+    // Diferencia para volver del estado nuevo al anterior
+    size_t size = rle_encode(rw->current, rw->head, rw->state_size, rw->scratch);
+    size_t offset;
+    if (reserve(rw, size, &offset)) {
+        memcpy(rw->data + offset, rw->scratch, size);
+        RewindEntry* entry = entry_at(rw, rw->count++);
+        entry->offset = offset;
+        entry->size = size;
+        rw->write = offset + size;
+        rw->used += size;
+    }
+
+    u8* old = rw->head;
+    rw->head = rw->current;
+    rw->current = old;
+}
+
+bool rewind_step_back(Rewind* rw, GameBoy* gb) {
+    if (rw->count == 0) return false;
+
+    RewindEntry* newest = entry_at(rw, rw->count - 1);
+    rle_apply(rw->head, rw->data + newest->offset, newest->size);
+    rw->used -= newest->size;
+    rw->write = newest->offset;
+    rw->count--;
+    if (rw->count == 0) rw->write = 0;
+
+    // La instancia, head y current vuelven a coincidir
+    if (!gb_load_state(gb, rw->head, rw->state_size)) return false;
+    memcpy(rw->current, rw->head, rw->state_size);
+    memset(rw->last_dirty, 0, sizeof(rw->last_dirty));
+    bus_clear_dirty(&gb->bus);
+    return true;
+}
@@ -0,0 +1,208 @@
+// src/rollback.c
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include "gb.h"
+#include "host_clock.h"
+#include "state.h"
+#include "rollback.h"
+
+// ------------------------------ Estados --------------------------------
+
+static u8* slot_state(Rollback* rb, u64 frame, int player) {
+    size_t slot = (size_t)(frame % (rb->max_frames + 1));
+    return rb->states + slot * (rb->state_size[0] + rb->state_size[1])
+                      + (player ? rb->state_size[0] : 0);
+}
+
+static void save_frame(Rollback* rb, u64 frame) {
+    for (int p = 0; p < 2; p++) {
+        gb_save_state(rb->gb[p], slot_state(rb, frame, p), rb->state_size[p]);
+    }
+}
+
+// Emula un frame de las dos consolas con la entrada guardada para él
+static void run_frame(Rollback* rb, u64 frame) {
+    for (int p = 0; p < 2; p++) {
+        joypad_set(rb->gb[p], rb->inputs[p][frame % ROLLBACK_INPUTS]);
+        gb_run_frame(rb->gb[p]);
+    }
+}
+
+// --------------------------- Entrada remota ----------------------------
+
+static bool remote_received(const Rollback* rb, u64 frame) {
+    return rb->received[frame % ROLLBACK_INPUTS] == frame;
+}
+
+// Entrada remota para un frame: la de verdad si ha llegado, si no la última
+static u8 remote_input(const Rollback* rb, u64 frame) {
+    u8 remote = rb->local ^ 1;
+    if (remote_received(rb, frame)) return rb->inputs[remote][frame % ROLLBACK_INPUTS];
+    return rb->has_remote ? rb->inputs[remote][rb->latest % ROLLBACK_INPUTS] : 0;
+}
+
+static void receive(Rollback* rb, const RollbackInput* input) {
+    u64 frame = input->frame;
+    // Repetidas, o fuera de la ventana (el otro extremo no respeta N)
+    if (frame < rb->confirmed || frame >= rb->confirmed + ROLLBACK_INPUTS || remote_received(rb, frame)) return;
+
+    u8 remote = rb->local ^ 1;
+    u8* slot = &rb->inputs[remote][frame % ROLLBACK_INPUTS];
+    if (frame < rb->frame && *slot != input->buttons && frame < rb->rollback_from) {
+        rb->rollback_from = frame;
+    }
+    *slot = input->buttons;
+    rb->received[frame % ROLLBACK_INPUTS] = frame;
+    if (!rb->has_remote || frame > rb->latest) rb->latest = frame;
+    rb->has_remote = true;
+
+    while (remote_received(rb, rb->confirmed)) rb->confirmed++;
+}
+
+// Vuelve al estado de rollback_from y emula otra vez hasta el frame actual
+static void resimulate(Rollback* rb) {
+    u64 start = now_ns();
+    u64 from = rb->rollback_from;
+    rb->rollback_from = UINT64_MAX;
+
+    // Sin audio y sin dibujar, salvo el último frame
+    bool synth[2];
+    u8 policy[2];
+    u32 interval[2];
+    for (int p = 0; p < 2; p++) {
+        GameBoy* gb = rb->gb[p];
+        apu_sync(gb);
+        synth[p] = gb->apu.synth;
+        policy[p] = gb->ppu.render_policy;
+        interval[p] = gb->ppu.render_interval;
+        gb_restore_state(gb, slot_state(rb, from, p), rb->state_size[p]);
+        gb->apu.synth = false;
+        ppu_set_render_policy(gb, PPU_RENDER_NEVER, 0);
+    }
+
+    u8 remote = rb->local ^ 1;
+    for (u64 f = from; f < rb->frame; f++) {
+        if (f > from) save_frame(rb, f);
+        if (f + 1 == rb->frame) {
+            for (int p = 0; p < 2; p++) ppu_set_render_policy(rb->gb[p], policy[p], interval[p]);
+        }
+        rb->inputs[remote][f % ROLLBACK_INPUTS] = remote_input(rb, f);
+        run_frame(rb, f);
+    }
+
+    // Lo vuelto a emular queda en silencio hasta aquí
+    for (int p = 0; p < 2; p++) {
+        if (synth[p]) apu_sync(rb->gb[p]);
+        rb->gb[p]->apu.synth = synth[p];
+        apu_resume_output(rb->gb[p]);
+    }
+
+    u32 frames = (u32)(rb->frame - from);
+    u64 ns = now_ns() - start;
+    rb->rollbacks++;
+    rb->resimulated += frames;
+    if (frames > rb->max_resimulated) rb->max_resimulated = frames;
+    rb->rollback_ns += ns;
+    if (ns > rb->max_rollback_ns) rb->max_rollback_ns = ns;
+}
+
+// ------------------------------ Interfaz -------------------------------
+
+bool rollback_init(Rollback* rb, GameBoy* gb0, GameBoy* gb1, u8 local,
+                   u32 max_frames, RollbackTransport transport) {
+    memset(rb, 0, sizeof(*rb));
+    if (local > 1 || max_frames == 0 || max_frames > ROLLBACK_MAX_FRAMES) return false;
+
+    rb->gb[0] = gb0;
+    rb->gb[1] = gb1;
+    rb->local = local;
+    rb->transport = transport;
+    rb->max_frames = max_frames;
+    rb->rollback_from = UINT64_MAX;
+    memset(rb->received, 0xFF, sizeof(rb->received));
+
+    rb->state_size[0] = gb_state_size(gb0);
+    rb->state_size[1] = gb_state_size(gb1);
+    rb->states = malloc((rb->state_size[0] + rb->state_size[1]) * (max_frames + 1));
+    return rb->states != NULL;
+}
+
+void rollback_free(Rollback* rb) {
+    free(rb->states);
+    memset(rb, 0, sizeof(*rb));
+}
+
+void rollback_update(Rollback* rb) {
+    RollbackInput input;
+    while (rb->transport.poll(rb->transport.ctx, &input)) receive(rb, &input);
+    if (rb->rollback_from < rb->frame) resimulate(rb);
+}
+
+bool rollback_frame(Rollback* rb, u8 buttons) {
+    rollback_update(rb);
+
+    // Para volver hasta el primer frame sin confirmar hace falta su estado
+    u64 frame = rb->frame;
+    if (frame >= rb->confirmed + rb->max_frames) {
+        rb->stalls++;
+        return false;
+    }
+
+    // Si el transporte no la acepta, el otro extremo no la recibiría nunca:
+    // se reintenta en la siguiente llamada
+    RollbackInput input = { frame, buttons };
+    if (!rb->transport.send(rb->transport.ctx, &input)) {
+        rb->stalls++;
+        return false;
+    }
+    rb->inputs[rb->local][frame % ROLLBACK_INPUTS] = buttons;
+    rb->inputs[rb->local ^ 1][frame % ROLLBACK_INPUTS] = remote_input(rb, frame);
+
+    save_frame(rb, frame);
+    run_frame(rb, frame);
+    rb->frame++;
+    return true;
+}
+
+// ------------------------------ Loopback -------------------------------
+
+static bool loopback_send(void* ctx, const RollbackInput* input) {
+    LoopbackEnd* end = ctx;
+    LoopbackLink* link = end->link;
+    u8 to = end->side ^ 1;
+    if (link->count[to] == LOOPBACK_CAPACITY) return false;
+
+    u32 tail = (link->head[to] + link->count[to]++) % LOOPBACK_CAPACITY;
+    link->queue[to][tail] = (LoopbackPacket){ *input, link->now + link->delay };
+    return true;
+}
+
+static bool loopback_poll(void* ctx, RollbackInput* input) {
+    LoopbackEnd* end = ctx;
+    LoopbackLink* link = end->link;
+    u8 side = end->side;
+    if (link->count[side] == 0) return false;
+
+    const LoopbackPacket* packet = &link->queue[side][link->head[side]];
+    if (packet->deliver > link->now) return false;
+
+    *input = packet->input;
+    link->head[side] = (link->head[side] + 1) % LOOPBACK_CAPACITY;
+    link->count[side]--;
+    return true;
+}
+
+void loopback_init(LoopbackLink* link, u32 delay) {
+    memset(link, 0, sizeof(*link));
+    link->delay = delay;
+    for (u8 side = 0; side < 2; side++) link->ends[side] = (LoopbackEnd){ link, side };
+}
+
+RollbackTransport loopback_transport(LoopbackLink* link, u8 side) {
+    return (RollbackTransport){ &link->ends[side & 1], loopback_send, loopback_poll };
+}
+
+void loopback_tick(LoopbackLink* link) {
+    link->now++;
+}
@@ -0,0 +1,64 @@
+// src/runahead.c
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include "gb.h"
+#include "host_clock.h"
+#include "state.h"
+#include "runahead.h"
+
+bool runahead_init(RunAhead* ra, const GameBoy* gb, u32 frames) {
+    memset(ra, 0, sizeof(*ra));
+    if (frames > RUNAHEAD_MAX_FRAMES) return false;
+
+    ra->frames = frames;
+    ra->size = gb_state_size(gb);
+    ra->state = malloc(ra->size);
+    return ra->state != NULL;
+}
+
+void runahead_free(RunAhead* ra) {
+    free(ra->state);
+    memset(ra, 0, sizeof(*ra));
+}
+
+u64 runahead_frame(RunAhead* ra, GameBoy* gb, u8 buttons) {
+    joypad_set(gb, buttons);
+    if (ra->frames == 0) return gb_run_frame(gb);
+
+    // El frame de verdad no se ve: no hace falta dibujarlo
+    u8 policy = gb->ppu.render_policy;
+    u32 interval = gb->ppu.render_interval;
+    ppu_set_render_policy(gb, PPU_RENDER_NEVER, 0);
+    u64 ticks = gb_run_frame(gb);
+
+    u64 start = now_ns();
+
+    // El audio queda sintetizado hasta aquí y los frames adelantados no
+    // generan nada (synth a mano: apu_set_synth reiniciaría la salida)
+    apu_sync(gb);
+    u64 dirty[BUS_DIRTY_WORDS];
+    memcpy(dirty, gb->bus.dirty, sizeof(dirty));
+    if (!gb_save_state(gb, ra->state, ra->size)) {
+        ppu_set_render_policy(gb, policy, interval);
+        return ticks;
+    }
+    bool synth = gb->apu.synth;
+    gb->apu.synth = false;
+
+    // Solo se dibuja el último
+    for (u32 k = 0; k < ra->frames; k++) {
+        if (k + 1 == ra->frames) ppu_set_render_policy(gb, policy, interval);
+        gb_run_frame(gb);
+    }
+
+    gb->apu.synth = synth;
+    gb_restore_state(gb, ra->state, ra->size);
+
+    // La memoria vuelve a ser la de antes de adelantar: lo sucio es lo mismo
+    memcpy(gb->bus.dirty, dirty, sizeof(dirty));
+
+    ra->extra_ns += now_ns() - start;
+    ra->frames_run++;
+    return ticks;
+}
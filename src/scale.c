@@ -0,0 +1,201 @@
+// src/scale.c
+#include <string.h>
+#include "scale.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SCALE_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+// Kernels: escalan una fila de entrada (width píxeles) a las filas de salida
+// que le corresponden. up y down son las filas vecinas (repetidas en los
+// bordes); solo las usa Scale2x.
+typedef void (*ScaleRowFn)(const u32* up, const u32* row, const u32* down,
+                           int width, u32* out, int out_width);
+
+// ------------------------------ Escalar --------------------------------
+
+static void nearest_row_scalar(int factor, const u32* row, int width, u32* out, int out_width) {
+    for (int x = 0; x < width; x++) {
+        for (int i = 0; i < factor; i++) out[x * factor + i] = row[x];
+    }
+    for (int i = 1; i < factor; i++) {
+        memcpy(&out[i * out_width], out, out_width * sizeof(u32));
+    }
+}
+
+static void nearest2_scalar(const u32* up, const u32* row, const u32* down, int width, u32* out, int out_width) {
+    (void)up; (void)down;
+    nearest_row_scalar(2, row, width, out, out_width);
+}
+
+static void nearest3_scalar(const u32* up, const u32* row, const u32* down, int width, u32* out, int out_width) {
+    (void)up; (void)down;
+    nearest_row_scalar(3, row, width, out, out_width);
+}
+
+static void nearest4_scalar(const u32* up, const u32* row, const u32* down, int width, u32* out, int out_width) {
+    (void)up; (void)down;
+    nearest_row_scalar(4, row, width, out, out_width);
+}
+
+// Scale2x sobre los píxeles [from, to) de una fila de width
+//     A        E0 E1
+//   C P B  ->  E2 E3
+//     D
+static void scale2x_span(const u32* up, const u32* row, const u32* down,
+                         int from, int to, int width, u32* out, int out_width) {
+    for (int x = from; x < to; x++) {
+        u32 a = up[x];
+        u32 d = down[x];
+        u32 c = row[x > 0 ? x - 1 : 0];
+        u32 b = row[x < width - 1 ? x + 1 : width - 1];
+        u32 p = row[x];
+
+        out[x * 2]                 = (c == a && c != d && a != b) ? a : p;
+        out[x * 2 + 1]             = (a == b && a != c && b != d) ? b : p;
+        out[out_width + x * 2]     = (d == c && d != b && c != a) ? c : p;
+        out[out_width + x * 2 + 1] = (b == d && b != a && d != c) ? d : p;
+    }
+}
+
+static void scale2x_scalar(const u32* up, const u32* row, const u32* down, int width, u32* out, int out_width) {
+    scale2x_span(up, row, down, 0, width, width, out, out_width);
+}
+
+#ifdef SCALE_HAVE_X86
+
+// -------------------------------- SSE2 ---------------------------------
+// Scale2x, 4 píxeles por iteración: las 4 condiciones con 4 PCMPEQD. Los
+// nearest no tienen versión SIMD: replicar y copiar filas con memcpy ya va
+// igual de rápido que con SSE2.
+
+// m ? a : p
+__attribute__((target("sse2")))
+static inline __m128i select_sse2(__m128i m, __m128i a, __m128i p) {
+    return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, p));
+}
+
+__attribute__((target("sse2")))
+static void scale2x_sse2(const u32* up, const u32* row, const u32* down, int width, u32* out, int out_width) {
+    // El primer y el último píxel necesitan el vecino repetido: escalares
+    scale2x_span(up, row, down, 0, 1, width, out, out_width);
+
+    int x = 1;
+    for (; x + 4 <= width - 1; x += 4) {
+        __m128i a = _mm_loadu_si128((const __m128i*)&up[x]);
+        __m128i d = _mm_loadu_si128((const __m128i*)&down[x]);
+        __m128i c = _mm_loadu_si128((const __m128i*)&row[x - 1]);
+        __m128i b = _mm_loadu_si128((const __m128i*)&row[x + 1]);
+        __m128i p = _mm_loadu_si128((const __m128i*)&row[x]);
+
+        __m128i ca = _mm_cmpeq_epi32(c, a);
+        __m128i ab = _mm_cmpeq_epi32(a, b);
+        __m128i cd = _mm_cmpeq_epi32(c, d);
+        __m128i bd = _mm_cmpeq_epi32(b, d);
+
+        __m128i e0 = select_sse2(_mm_andnot_si128(_mm_or_si128(cd, ab), ca), a, p);
+        __m128i e1 = select_sse2(_mm_andnot_si128(_mm_or_si128(ca, bd), ab), b, p);
+        __m128i e2 = select_sse2(_mm_andnot_si128(_mm_or_si128(bd, ca), cd), c, p);
+        __m128i e3 = select_sse2(_mm_andnot_si128(_mm_or_si128(ab, cd), bd), d, p);
+
+        u32* top = &out[x * 2];
+        u32* bottom = &out[out_width + x * 2];
+        _mm_storeu_si128((__m128i*)top,          _mm_unpacklo_epi32(e0, e1));
+        _mm_storeu_si128((__m128i*)(top + 4),    _mm_unpackhi_epi32(e0, e1));
+        _mm_storeu_si128((__m128i*)bottom,       _mm_unpacklo_epi32(e2, e3));
+        _mm_storeu_si128((__m128i*)(bottom + 4), _mm_unpackhi_epi32(e2, e3));
+    }
+
+    scale2x_span(up, row, down, x, width, width, out, out_width);
+}
+
+#endif // SCALE_HAVE_X86
+
+// --------------------------- Selección ---------------------------------
+
+static ScaleRowFn scale_rows[SCALE_FILTER_COUNT] = {
+    nearest2_scalar, nearest3_scalar, nearest4_scalar, scale2x_scalar,
+};
+
+bool scale_set_backend(TileBackend backend) {
+    switch (backend) {
+        case TILE_BACKEND_SCALAR:
+            scale_rows[SCALE_SCALE2X] = scale2x_scalar;
+            return true;
+#ifdef SCALE_HAVE_X86
+        case TILE_BACKEND_SSE:
+        case TILE_BACKEND_AVX2:
+            __builtin_cpu_init();
+            if (!__builtin_cpu_supports("sse2")) return false;
+            scale_rows[SCALE_SCALE2X] = scale2x_sse2;
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+// Elegido por scale_init (-1 = todavía no; atómico)
+static int best_backend = -1;
+
+TileBackend scale_init(void) {
+    int best = __atomic_load_n(&best_backend, __ATOMIC_ACQUIRE);
+    if (best >= 0) return (TileBackend)best;
+
+    if (scale_set_backend(TILE_BACKEND_SSE)) best = TILE_BACKEND_SSE;
+    else {
+        scale_set_backend(TILE_BACKEND_SCALAR);
+        best = TILE_BACKEND_SCALAR;
+    }
+    __atomic_store_n(&best_backend, best, __ATOMIC_RELEASE);
+    return (TileBackend)best;
+}
+
+// ------------------------------ Interfaz -------------------------------
+
+int scale_factor(ScaleFilter filter) {
+    switch (filter) {
+        case SCALE_NEAREST_3X: return 3;
+        case SCALE_NEAREST_4X: return 4;
+        default:               return 2;
+    }
+}
+
+const char* scale_filter_name(ScaleFilter filter) {
+    switch (filter) {
+        case SCALE_NEAREST_2X: return "2x";
+        case SCALE_NEAREST_3X: return "3x";
+        case SCALE_NEAREST_4X: return "4x";
+        case SCALE_SCALE2X:    return "scale2x";
+        default:               return "?";
+    }
+}
+
+bool scale_filter_parse(const char* name, ScaleFilter* filter) {
+    for (int f = 0; f < SCALE_FILTER_COUNT; f++) {
+        if (strcmp(name, scale_filter_name(f)) == 0) {
+            *filter = f;
+            return true;
+        }
+    }
+    return false;
+}
+
+void scale_image(ScaleFilter filter, const u32* in, int width, int height, u32* out) {
+    int factor = scale_factor(filter);
+    int out_width = width * factor;
+    ScaleRowFn fn = scale_rows[filter];
+
+    for (int y = 0; y < height; y++) {
+        const u32* row = &in[y * width];
+        const u32* up = y > 0 ? row - width : row;
+        const u32* down = y < height - 1 ? row + width : row;
+        fn(up, row, down, width, &out[(size_t)y * factor * out_width], out_width);
+    }
+}
+
+void scale_frame(ScaleFilter filter, const Frame* frame, u32* rgba, u32* out) {
+    fb_to_rgba(frame, (u8*)rgba);
+    scale_image(filter, rgba, LCD_WIDTH, LCD_HEIGHT, out);
+}
@@ -0,0 +1,53 @@
+// src/sched.c
+#include "gb.h"
+
+// Manejador de cada tipo de evento
+typedef void (*EventHandler)(GameBoy* gb);
+
+static const EventHandler event_handlers[EVENT_COUNT] = {
+    [EVENT_DMA] = dma_event,
+    [EVENT_PPU] = ppu_event,
+    [EVENT_TIMER] = timer_event,
+    [EVENT_SERIAL] = serial_event,
+};
+
+// Recalcula el evento más próximo
+static void sched_update_next(Scheduler* sched) {
+    u64 next = SCHED_NEVER;
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        if (sched->when[i] < next) next = sched->when[i];
+    }
+    sched->next = next;
+}
+
+void sched_init(Scheduler* sched) {
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        sched->when[i] = SCHED_NEVER;
+    }
+    sched->next = SCHED_NEVER;
+}
+
+void sched_schedule(GameBoy* gb, EventType type, u64 when) {
+    gb->sched.when[type] = when;
+    sched_update_next(&gb->sched);
+}
+
+void sched_cancel(GameBoy* gb, EventType type) {
+    gb->sched.when[type] = SCHED_NEVER;
+    sched_update_next(&gb->sched);
+}
+
+void sched_run(GameBoy* gb) {
+    // Un manejador puede reprogramar su propio evento (o el de otro), así que
+    // buscamos de nuevo el más antiguo vencido en cada vuelta.
+    while (gb->sched.next <= gb->ticks) {
+        int type = 0;
+        for (int i = 1; i < EVENT_COUNT; i++) {
+            if (gb->sched.when[i] < gb->sched.when[type]) type = i;
+        }
+
+        gb->sched.when[type] = SCHED_NEVER;
+        sched_update_next(&gb->sched);
+        event_handlers[type](gb);
+    }
+}
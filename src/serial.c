@@ -0,0 +1,150 @@
+// src/serial.c
+#include "gb.h"
+
+// Esta consola está mandando un byte (reloj interno)
+static bool serial_master(const GameBoy* gb) {
+    u8 sc = gb->bus.io[REG_SC];
+    return BIT(sc, SC_START) && BIT(sc, SC_CLOCK);
+}
+
+// Esta consola espera el reloj de la otra
+static bool serial_waiting(const GameBoy* gb) {
+    u8 sc = gb->bus.io[REG_SC];
+    return BIT(sc, SC_START) && !BIT(sc, SC_CLOCK);
+}
+
+static void serial_finish(GameBoy* gb, u8 received) {
+    gb->bus.io[REG_SB] = received;
+    gb->bus.io[REG_SC] &= ~(1 << SC_START);
+    sched_cancel(gb, EVENT_SERIAL);
+    cpu_request_interrupt(gb, INT_SERIAL);
+}
+
+// Fin de la transferencia de master: intercambio con la otra si espera
+static void serial_complete(GameBoy* master) {
+    GameBoy* peer = master->serial.peer;
+    u8 received = 0xFF;
+    if (peer && serial_waiting(peer)) {
+        received = peer->bus.io[REG_SB];
+        serial_finish(peer, master->bus.io[REG_SB]);
+    }
+    serial_finish(master, received);
+}
+
+// Hace avanzar gb hasta el instante when de su reloj (o hasta un STOP)
+static void run_until(GameBoy* gb, u64 when) {
+    while (gb->ticks < when) {
+        if (gb_step(gb) == 0) break;
+    }
+}
+
+// Tras un STOP (el reloj de esa consola no ha avanzado) el instante actual
+// de las dos vuelve a ser el mismo
+static void serial_rebase(GameBoy* gb) {
+    GameBoy* peer = gb->serial.peer;
+    gb->serial.offset = peer->ticks - gb->ticks;
+    peer->serial.offset = gb->ticks - peer->ticks;
+}
+
+void serial_init(GameBoy* gb) {
+    gb->bus.io[REG_SB] = 0x00;
+    gb->bus.io[REG_SC] = 0x00;
+    gb->serial.peer = NULL;
+    gb->serial.offset = 0;
+}
+
+u8 serial_read(GameBoy* gb, u16 address) {
+    if (address == REG_SB_ADDR) return gb->bus.io[REG_SB];
+    // Los bits 1-6 de SC no existen (se leen a 1)
+    return gb->bus.io[REG_SC] | 0x7E;
+}
+
+void serial_write(GameBoy* gb, u16 address, u8 value) {
+    if (address == REG_SB_ADDR) {
+        gb->bus.io[REG_SB] = value;
+        return;
+    }
+
+    gb->bus.io[REG_SC] = value & ((1 << SC_START) | (1 << SC_CLOCK));
+    GameBoy* peer = gb->serial.peer;
+    if (!serial_master(gb)) {
+        // Con reloj externo el fin lo marca la otra. Si ya está mandando, se
+        // mantiene el fin de su transferencia: si esta va por delante, tiene
+        // que pararse ahí a esperarla.
+        if (peer && serial_master(peer)) {
+            sched_schedule(gb, EVENT_SERIAL, peer->sched.when[EVENT_SERIAL] + peer->serial.offset);
+        }
+        else {
+            sched_cancel(gb, EVENT_SERIAL);
+        }
+        return;
+    }
+
+    // El fin, en las dos (salvo que la otra esté mandando su propio byte)
+    u64 end = gb->ticks + SERIAL_TRANSFER_TICKS;
+    sched_schedule(gb, EVENT_SERIAL, end);
+    if (peer && !serial_master(peer)) {
+        sched_schedule(peer, EVENT_SERIAL, end + gb->serial.offset);
+    }
+}
+
+void serial_event(GameBoy* gb) {
+    GameBoy* peer = gb->serial.peer;
+    GameBoy* master = serial_master(gb) ? gb : (peer && serial_master(peer)) ? peer : NULL;
+    if (!master) return;
+
+    if (peer) {
+        // La otra hasta este mismo instante. Si es la que manda, su propio
+        // evento completa la transferencia por el camino.
+        run_until(peer, gb->ticks + gb->serial.offset);
+        if (!serial_master(master)) return;
+
+        u64 end = master->sched.when[EVENT_SERIAL];
+        if (end != SCHED_NEVER && end > master->ticks) return;
+    }
+    serial_complete(master);
+}
+
+void serial_connect(GameBoy* a, GameBoy* b) {
+    serial_disconnect(a);
+    serial_disconnect(b);
+    a->serial.peer = b;
+    b->serial.peer = a;
+    serial_rebase(a);
+}
+
+void serial_disconnect(GameBoy* gb) {
+    GameBoy* peer = gb->serial.peer;
+    if (peer) peer->serial.peer = NULL;
+    gb->serial.peer = NULL;
+}
+
+u64 serial_run_frame(GameBoy* gb) {
+    GameBoy* peer = gb->serial.peer;
+    if (!peer) return gb_run_frame(gb);
+
+    // Está en STOP: la otra sigue por su cuenta
+    if (gb->cpu.stopped) {
+        gb_run_frame(peer);
+        serial_rebase(gb);
+        return 0;
+    }
+
+    u64 start = gb->ticks;
+    u64 frame = gb->ppu.frame_count;
+    bool stopped = false;
+    while (!stopped && gb->ppu.frame_count == frame && gb->ticks - start < FRAME_TICKS) {
+        u64 slice = gb->ticks + SERIAL_QUANTUM;
+        if (slice > start + FRAME_TICKS) slice = start + FRAME_TICKS;
+        while (gb->ppu.frame_count == frame && gb->ticks < slice) {
+            if (gb_step(gb) == 0) {
+                stopped = true;
+                break;
+            }
+        }
+
+        run_until(peer, gb->ticks + gb->serial.offset);
+        if (stopped || peer->cpu.stopped) serial_rebase(gb);
+    }
+    return gb->ticks - start;
+}
@@ -0,0 +1,598 @@
+// src/state.c
+#include <string.h>
+#include "gb.h"
+#include "state.h"
+#include "hash.h"
+
+// Cabecera del cartucho usada para reconocer la ROM
+#define HEADER_CHECKSUM 0x014D // Checksum de la cabecera + global (3 bytes)
+
+// ------------------------------ Escritura ------------------------------
+
+// Con data == NULL solo se cuentan bytes (tamaño de cada sección).
+// Con pages, data ya tiene un estado anterior y de la memoria solo se
+// copian las páginas marcadas (gb_update_state).
+typedef struct {
+    u8* data;
+    size_t pos;
+    size_t capacity;
+    const u64* pages;
+} StateWriter;
+
+static void put_bytes(StateWriter* w, const void* src, size_t n) {
+    if (w->data && w->pos + n <= w->capacity) memcpy(w->data + w->pos, src, n);
+    w->pos += n;
+}
+
+// Memoria mapeada desde base: con pages, las páginas limpias se saltan
+static void put_memory(StateWriter* w, const u8* src, size_t size, u16 base) {
+    if (!w->pages) {
+        put_bytes(w, src, size);
+        return;
+    }
+    for (size_t off = 0; off < size; off += BUS_PAGE_SIZE) {
+        size_t n = size - off < BUS_PAGE_SIZE ? size - off : BUS_PAGE_SIZE;
+        if (bus_page_dirty(w->pages, base + off)) put_bytes(w, src + off, n);
+        else w->pos += n;
+    }
+}
+
+static void put_u8(StateWriter* w, u8 v) {
+    put_bytes(w, &v, 1);
+}
+
+static void put_u16(StateWriter* w, u16 v) {
+    u8 b[2] = { v, v >> 8 };
+    put_bytes(w, b, 2);
+}
+
+static void put_u32(StateWriter* w, u32 v) {
+    u8 b[4] = { v, v >> 8, v >> 16, v >> 24 };
+    put_bytes(w, b, 4);
+}
+
+static void put_u64(StateWriter* w, u64 v) {
+    put_u32(w, (u32)v);
+    put_u32(w, (u32)(v >> 32));
+}
+
+// ------------------------------ Lectura --------------------------------
+
+// Las longitudes se validan antes de leer, así que aquí no hay comprobaciones
+typedef struct {
+    const u8* data;
+    size_t pos;
+} StateReader;
+
+static void get_bytes(StateReader* r, void* dst, size_t n) {
+    memcpy(dst, r->data + r->pos, n);
+    r->pos += n;
+}
+
+static u8 get_u8(StateReader* r) {
+    return r->data[r->pos++];
+}
+
+static u16 get_u16(StateReader* r) {
+    u16 v = r->data[r->pos] | (r->data[r->pos + 1] << 8);
+    r->pos += 2;
+    return v;
+}
+
+static u32 get_u32(StateReader* r) {
+    const u8* b = r->data + r->pos;
+    r->pos += 4;
+    return b[0] | (b[1] << 8) | (b[2] << 16) | ((u32)b[3] << 24);
+}
+
+static u64 get_u64(StateReader* r) {
+    u64 lo = get_u32(r);
+    return lo | ((u64)get_u32(r) << 32);
+}
+
+// ------------------------------ Secciones ------------------------------
+
+static void save_cpu(StateWriter* w, const GameBoy* gb) {
+    const Cpu* cpu = &gb->cpu;
+    u8 regs[8] = { cpu->a, cpu->f, cpu->b, cpu->c, cpu->d, cpu->e, cpu->h, cpu->l };
+    put_bytes(w, regs, sizeof(regs));
+    put_u16(w, cpu->sp);
+    put_u16(w, cpu->pc);
+    put_u8(w, cpu->ie);
+    put_u8(w, cpu->if_reg);
+    put_u8(w, cpu->ime);
+    put_u8(w, cpu->halted);
+    put_u8(w, cpu->halt_bug);
+    put_u8(w, cpu->stopped);
+    put_u8(w, cpu->cycles);
+}
+
+static void load_cpu(StateReader* r, GameBoy* gb) {
+    Cpu* cpu = &gb->cpu;
+    u8 regs[8];
+    get_bytes(r, regs, sizeof(regs));
+    cpu->a = regs[0]; cpu->f = regs[1];
+    cpu->b = regs[2]; cpu->c = regs[3];
+    cpu->d = regs[4]; cpu->e = regs[5];
+    cpu->h = regs[6]; cpu->l = regs[7];
+    cpu->sp = get_u16(r);
+    cpu->pc = get_u16(r);
+    cpu->ie = get_u8(r);
+    cpu->if_reg = get_u8(r);
+    cpu->ime = get_u8(r);
+    cpu->halted = get_u8(r);
+    cpu->halt_bug = get_u8(r);
+    cpu->stopped = get_u8(r);
+    cpu->cycles = get_u8(r);
+}
+
+// La memoria plana del modo test no forma parte del estado
+static void save_bus(StateWriter* w, const GameBoy* gb) {
+    const Bus* bus = &gb->bus;
+    put_memory(w, bus->wram, WRAM_SIZE, 0xC000);
+    put_memory(w, bus->vram, VRAM_SIZE, 0x8000);
+    put_memory(w, bus->hram, HRAM_SIZE, 0xFF80);
+    put_memory(w, bus->oam, OAM_SIZE, 0xFE00);
+    put_bytes(w, bus->io, sizeof(bus->io));
+    put_u8(w, bus->access_mode);
+}
+
+static void load_bus(StateReader* r, GameBoy* gb) {
+    Bus* bus = &gb->bus;
+    get_bytes(r, bus->wram, WRAM_SIZE);
+    get_bytes(r, bus->vram, VRAM_SIZE);
+    get_bytes(r, bus->hram, HRAM_SIZE);
+    get_bytes(r, bus->oam, OAM_SIZE);
+    get_bytes(r, bus->io, sizeof(bus->io));
+    bus->access_mode = get_u8(r);
+
+    // Toda la memoria ha cambiado
+    for (int i = 0; i < BUS_DIRTY_WORDS; i++) bus->dirty[i] = ~0ULL;
+}
+
+// Solo bits de modo conocidos
+static bool check_bus(const GameBoy* gb, const u8* data) {
+    StateReader r = { data, WRAM_SIZE + VRAM_SIZE + HRAM_SIZE + OAM_SIZE + sizeof(gb->bus.io) };
+    return (get_u8(&r) & ~(BUS_MODE_TEST | BUS_MODE_DMA)) == 0;
+}
+
+// Reloj y eventos programados
+static void save_clock(StateWriter* w, const GameBoy* gb) {
+    put_u64(w, gb->ticks);
+    put_u8(w, gb->paused);
+    for (int i = 0; i < EVENT_COUNT; i++) put_u64(w, gb->sched.when[i]);
+}
+
+static void load_clock(StateReader* r, GameBoy* gb) {
+    gb->ticks = get_u64(r);
+    gb->paused = get_u8(r);
+
+    u64 next = SCHED_NEVER;
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        gb->sched.when[i] = get_u64(r);
+        if (gb->sched.when[i] < next) next = gb->sched.when[i];
+    }
+    gb->sched.next = next;
+}
+
+static void save_dma(StateWriter* w, const GameBoy* gb) {
+    put_u8(w, gb->dma.active);
+    put_u16(w, gb->dma.source);
+    put_u64(w, gb->dma.start);
+    put_u8(w, gb->dma.copied);
+}
+
+static void load_dma(StateReader* r, GameBoy* gb) {
+    gb->dma.active = get_u8(r);
+    gb->dma.source = get_u16(r);
+    gb->dma.start = get_u64(r);
+    gb->dma.copied = get_u8(r);
+}
+
+// copied es el siguiente byte a copiar a la OAM
+static bool check_dma(const GameBoy* gb, const u8* data) {
+    (void)gb;
+    StateReader r = { data, 1 + 2 + 8 }; // active, source, start
+    return get_u8(&r) <= DMA_LENGTH;
+}
+
+static void save_timer(StateWriter* w, const GameBoy* gb) {
+    put_u64(w, gb->timer.div_base);
+    put_u64(w, gb->timer.tima_time);
+    put_u8(w, gb->timer.tima);
+    put_u8(w, gb->timer.tma);
+    put_u8(w, gb->timer.tac);
+}
+
+static void save_joypad(StateWriter* w, const GameBoy* gb) {
+    put_u8(w, gb->joypad.buttons);
+    put_u8(w, gb->joypad.select);
+}
+
+static void load_joypad(StateReader* r, GameBoy* gb) {
+    gb->joypad.buttons = get_u8(r);
+    gb->joypad.select = get_u8(r) & 0x30;
+}
+
+static void load_timer(StateReader* r, GameBoy* gb) {
+    gb->timer.div_base = get_u64(r);
+    gb->timer.tima_time = get_u64(r);
+    gb->timer.tima = get_u8(r);
+    gb->timer.tma = get_u8(r);
+    gb->timer.tac = get_u8(r);
+}
+
+// Solo el estado de la emulación: las cachés se reconstruyen y la política
+// de dibujado, el backend y la caché de líneas son de quien usa la instancia
+static void save_ppu(StateWriter* w, const GameBoy* gb) {
+    const Ppu* ppu = &gb->ppu;
+    put_u8(w, ppu->mode);
+    put_u8(w, ppu->window_line);
+    put_u8(w, ppu->stat_line);
+    put_u64(w, ppu->line_start);
+    put_u64(w, ppu->frame_count);
+    put_u8(w, ppu->render_frame);
+    put_u8(w, ppu->render_request);
+
+    const PpuFifo* f = &ppu->fifo;
+    put_u64(w, f->tick);
+    put_u64(w, f->end_tick);
+    u8 bytes[] = {
+        f->done, f->startup, f->stall, f->lx, f->discard,
+        f->fetch_step, f->fetch_x, f->tile_no, f->data[0], f->data[1],
+        f->window, f->bg_head, f->bg_count, f->sprite_count,
+    };
+    put_bytes(w, bytes, sizeof(bytes));
+    put_bytes(w, f->bg, sizeof(f->bg));
+    put_bytes(w, f->obj, sizeof(f->obj));
+    put_bytes(w, f->sprites, sizeof(f->sprites));
+    put_u16(w, f->sprites_done);
+}
+
+static void get_fifo(StateReader* r, PpuFifo* f) {
+    f->tick = get_u64(r);
+    f->end_tick = get_u64(r);
+    f->done = get_u8(r);
+    f->startup = get_u8(r);
+    f->stall = get_u8(r);
+    f->lx = get_u8(r);
+    f->discard = get_u8(r);
+    f->fetch_step = get_u8(r);
+    f->fetch_x = get_u8(r);
+    f->tile_no = get_u8(r);
+    f->data[0] = get_u8(r);
+    f->data[1] = get_u8(r);
+    f->window = get_u8(r);
+    f->bg_head = get_u8(r);
+    f->bg_count = get_u8(r);
+    f->sprite_count = get_u8(r);
+    get_bytes(r, f->bg, sizeof(f->bg));
+    get_bytes(r, f->obj, sizeof(f->obj));
+    get_bytes(r, f->sprites, sizeof(f->sprites));
+    f->sprites_done = get_u16(r);
+}
+
+static void load_ppu(StateReader* r, GameBoy* gb) {
+    Ppu* ppu = &gb->ppu;
+    ppu->mode = get_u8(r);
+    ppu->window_line = get_u8(r);
+    ppu->stat_line = get_u8(r);
+    ppu->line_start = get_u64(r);
+    ppu->frame_count = get_u64(r);
+    ppu->render_frame = get_u8(r);
+    ppu->render_request = get_u8(r);
+    get_fifo(r, &ppu->fifo);
+}
+
+// Modo y posiciones del FIFO: se usan como índices
+static bool check_ppu(const GameBoy* gb, const u8* data) {
+    (void)gb;
+    StateReader r = { data, 0 };
+    u8 mode = get_u8(&r);
+    r.pos += 1 + 1 + 8 + 8 + 1 + 1; // Hasta el FIFO
+
+    PpuFifo f;
+    get_fifo(&r, &f);
+    if (mode > PPU_MODE_DRAW || f.lx > LCD_WIDTH) return false;
+    if (f.bg_head + f.bg_count > 8 || f.sprite_count > SPRITES_PER_LINE) return false;
+    for (int s = 0; s < f.sprite_count; s++) {
+        if (f.sprites[s] >= OAM_ENTRIES) return false;
+    }
+    return true;
+}
+
+// Sin la salida (Blip): al cargar, el audio sigue desde el estado de los
+// canales. La frecuencia de muestreo y el modo sin audio no se tocan.
+static void save_apu(StateWriter* w, const GameBoy* gb) {
+    const Apu* apu = &gb->apu;
+    for (int n = 0; n < APU_CHANNELS; n++) {
+        const ApuChannel* ch = &apu->ch[n];
+        put_u8(w, ch->enabled);
+        put_u8(w, ch->dac);
+        put_u16(w, ch->length);
+        put_u8(w, ch->length_enable);
+        put_u64(w, ch->next_edge);
+        put_u8(w, ch->step);
+        put_u16(w, ch->lfsr);
+        put_u8(w, ch->volume);
+        put_u8(w, ch->env_period);
+        put_u8(w, ch->env_up);
+        put_u8(w, ch->env_timer);
+    }
+    put_u16(w, apu->sweep_shadow);
+    put_u8(w, apu->sweep_timer);
+    put_u8(w, apu->sweep_enabled);
+    put_u64(w, apu->next_seq);
+    put_u8(w, apu->seq_step);
+    put_u64(w, apu->time);
+}
+
+static void get_channel(StateReader* r, ApuChannel* ch) {
+    ch->enabled = get_u8(r);
+    ch->dac = get_u8(r);
+    ch->length = get_u16(r);
+    ch->length_enable = get_u8(r);
+    ch->next_edge = get_u64(r);
+    ch->step = get_u8(r);
+    ch->lfsr = get_u16(r);
+    ch->volume = get_u8(r);
+    ch->env_period = get_u8(r);
+    ch->env_up = get_u8(r);
+    ch->env_timer = get_u8(r);
+}
+
+static void load_apu(StateReader* r, GameBoy* gb) {
+    Apu* apu = &gb->apu;
+    for (int n = 0; n < APU_CHANNELS; n++) get_channel(r, &apu->ch[n]);
+    apu->sweep_shadow = get_u16(r);
+    apu->sweep_timer = get_u8(r);
+    apu->sweep_enabled = get_u8(r);
+    apu->next_seq = get_u64(r);
+    apu->seq_step = get_u8(r);
+    apu->time = get_u64(r);
+}
+
+// La posición en la onda indexa la tabla de duty o la RAM de onda
+static bool check_apu(const GameBoy* gb, const u8* data) {
+    (void)gb;
+    StateReader r = { data, 0 };
+    for (int n = 0; n < APU_CHANNELS; n++) {
+        ApuChannel ch;
+        get_channel(&r, &ch);
+        if (ch.step >= (n == APU_CH_WAVE ? 32 : 8)) return false;
+    }
+    return true;
+}
+
+// Identificación de la ROM (tamaño y checksums de la cabecera), registros
+// del MBC y RAM externa
+static void save_cart(StateWriter* w, const GameBoy* gb) {
+    const Cart* cart = &gb->cart;
+    put_u32(w, (u32)cart->rom_size);
+    put_bytes(w, cart->rom ? &cart->rom[HEADER_CHECKSUM] : (const u8[3]){ 0 }, 3);
+    put_u8(w, cart->ram_enable);
+    put_u16(w, cart->rom_bank);
+    put_u8(w, cart->ram_bank);
+    put_u8(w, cart->mode);
+
+    // No se sabe en qué banco se escribió: cualquier página de $A000-$BFFF
+    // obliga a copiar toda la RAM
+    bool dirty = !w->pages;
+    for (u32 a = 0xA000; a < 0xC000 && !dirty; a += BUS_PAGE_SIZE) {
+        dirty = bus_page_dirty(w->pages, a);
+    }
+    for (int n = 0; n < cart->ram_banks; n++) {
+        if (dirty) put_bytes(w, cart_ram_bank(cart, n), RAM_BANK_SIZE);
+        else w->pos += RAM_BANK_SIZE;
+    }
+}
+
+static void load_cart(StateReader* r, GameBoy* gb) {
+    Cart* cart = &gb->cart;
+    r->pos += 4 + 3; // Ya comprobado en check_cart
+    cart->ram_enable = get_u8(r);
+    cart->rom_bank = get_u16(r);
+    cart->ram_bank = get_u8(r);
+    cart->mode = get_u8(r);
+    for (int n = 0; n < cart->ram_banks; n++) {
+        u8* bank = cart_ram_bank_writable(cart, n);
+        if (bank) get_bytes(r, bank, RAM_BANK_SIZE);
+        else r->pos += RAM_BANK_SIZE;
+    }
+}
+
+// La ROM del estado tiene que ser la cargada
+static bool check_cart(const GameBoy* gb, const u8* data) {
+    const Cart* cart = &gb->cart;
+    StateReader r = { data, 0 };
+    if (get_u32(&r) != (u32)cart->rom_size) return false;
+    if (!cart->rom) return true;
+    return memcmp(data + 4, &cart->rom[HEADER_CHECKSUM], 3) == 0;
+}
+
+// Las líneas ya dibujadas del frame en curso. El resto del frame de dibujo
+// tiene restos de frames antiguos, que no forman parte del estado: se
+// guardan como ceros para que dos instancias iguales den el mismo estado.
+static void save_lcd(StateWriter* w, const GameBoy* gb) {
+    const Ppu* ppu = &gb->ppu;
+    int lines = 0;
+    if (ppu->render_frame && ppu->mode != PPU_MODE_VBLANK) {
+        // La línea en curso puede estar a medias (backend FIFO)
+        lines = gb->bus.io[REG_LY] + (ppu->mode == PPU_MODE_OAM ? 0 : 1);
+        if (lines > LCD_HEIGHT) lines = LCD_HEIGHT;
+    }
+
+    static const u8 blank[FB_LINE_BYTES];
+    for (int ly = 0; ly < LCD_HEIGHT; ly++) {
+        put_bytes(w, ly < lines ? gb->fb.frames[gb->fb.back].pixels[ly] : blank, FB_LINE_BYTES);
+    }
+}
+
+static void load_lcd(StateReader* r, GameBoy* gb) {
+    get_bytes(r, gb->fb.frames[gb->fb.back].pixels, FB_FRAME_BYTES);
+}
+
+typedef struct {
+    char tag[4];
+    void (*save)(StateWriter* w, const GameBoy* gb);
+    void (*load)(StateReader* r, GameBoy* gb);
+    bool (*check)(const GameBoy* gb, const u8* data); // NULL: sin comprobar
+} StateSection;
+
+static const StateSection sections[] = {
+    { "CPU ", save_cpu, load_cpu, NULL },
+    { "BUS ", save_bus, load_bus, check_bus },
+    { "CLK ", save_clock, load_clock, NULL },
+    { "DMA ", save_dma, load_dma, check_dma },
+    { "TIMR", save_timer, load_timer, NULL },
+    { "JOYP", save_joypad, load_joypad, NULL },
+    { "PPU ", save_ppu, load_ppu, check_ppu },
+    { "APU ", save_apu, load_apu, check_apu },
+    { "CART", save_cart, load_cart, check_cart },
+    { "LCD ", save_lcd, load_lcd, NULL },
+};
+
+#define SECTION_COUNT (int)(sizeof(sections) / sizeof(sections[0]))
+#define HEADER_BYTES  8
+#define SECTION_HEADER_BYTES 8
+
+static size_t section_size(const StateSection* s, const GameBoy* gb) {
+    StateWriter counter = { NULL, 0, 0, NULL };
+    s->save(&counter, gb);
+    return counter.pos;
+}
+
+// ------------------------------ Interfaz -------------------------------
+
+size_t gb_state_size(const GameBoy* gb) {
+    size_t size = HEADER_BYTES;
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        size += SECTION_HEADER_BYTES + section_size(&sections[i], gb);
+    }
+    return size;
+}
+
+static void write_state(StateWriter* w, const GameBoy* gb) {
+    put_bytes(w, GB_STATE_MAGIC, 4);
+    put_u32(w, GB_STATE_VERSION);
+
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        put_bytes(w, sections[i].tag, 4);
+        size_t length_pos = w->pos;
+        put_u32(w, 0);
+
+        size_t start = w->pos;
+        sections[i].save(w, gb);
+
+        // Longitud real, ahora que se conoce
+        StateWriter length = { w->data, length_pos, w->capacity, NULL };
+        put_u32(&length, (u32)(w->pos - start));
+    }
+}
+
+size_t gb_save_state(const GameBoy* gb, u8* buf, size_t capacity) {
+    StateWriter w = { buf, 0, capacity, NULL };
+    write_state(&w, gb);
+    return w.pos <= capacity ? w.pos : 0;
+}
+
+bool gb_update_state(const GameBoy* gb, u8* buf, size_t size, const u64* pages) {
+    if (size != gb_state_size(gb) || memcmp(buf, GB_STATE_MAGIC, 4) != 0) return false;
+
+    StateWriter w = { buf, 0, size, pages };
+    write_state(&w, gb);
+    return true;
+}
+
+static bool load_state(GameBoy* gb, const u8* data, size_t size, bool reset_audio) {
+    if (size < HEADER_BYTES || memcmp(data, GB_STATE_MAGIC, 4) != 0) return false;
+
+    StateReader r = { data, 4 };
+    if (get_u32(&r) != GB_STATE_VERSION) return false;
+
+    // Primera pasada: validar sin tocar la instancia
+    const u8* found[SECTION_COUNT] = { 0 };
+    while (r.pos < size) {
+        if (size - r.pos < SECTION_HEADER_BYTES) return false;
+        const u8* tag = data + r.pos;
+        r.pos += 4;
+        u32 length = get_u32(&r);
+        if (length > size - r.pos) return false;
+
+        for (int i = 0; i < SECTION_COUNT; i++) {
+            if (memcmp(tag, sections[i].tag, 4) != 0) continue;
+            if (found[i] || length != section_size(&sections[i], gb)) return false;
+            if (sections[i].check && !sections[i].check(gb, data + r.pos)) return false;
+            found[i] = data + r.pos;
+        }
+        r.pos += length;
+    }
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        if (!found[i]) return false;
+    }
+
+    // Segunda pasada: copiar
+    for (int i = 0; i < SECTION_COUNT; i++) {
+        StateReader section = { found[i], 0 };
+        sections[i].load(&section, gb);
+    }
+
+    // Lo que se deriva del estado, en lugar de guardarse
+    ppu_invalidate_caches(gb);
+    if (reset_audio) apu_reset_output(gb);
+    return true;
+}
+
+bool gb_load_state(GameBoy* gb, const u8* data, size_t size) {
+    return load_state(gb, data, size, true);
+}
+
+bool gb_restore_state(GameBoy* gb, const u8* data, size_t size) {
+    return load_state(gb, data, size, false);
+}
+
+// -------------------------------- Hash ---------------------------------
+
+// Rehashea las páginas de una memoria mapeada desde base
+static void hash_memory(MemoryHash* mh, const u8* src, size_t size, u16 base, const u64* pages) {
+    for (size_t off = 0; off < size; off += BUS_PAGE_SIZE) {
+        u16 page = (base + off) >> BUS_PAGE_SHIFT;
+        if (pages && !bus_page_dirty(pages, base + off)) continue;
+        size_t n = size - off < BUS_PAGE_SIZE ? size - off : BUS_PAGE_SIZE;
+        mh->page[page] = hash_bytes(src + off, n, HASH_SEED ^ page);
+    }
+}
+
+void memory_hash_init(MemoryHash* mh) {
+    memset(mh, 0, sizeof(*mh));
+}
+
+u64 gb_memory_hash(const GameBoy* gb, MemoryHash* mh, const u64* pages) {
+    if (!mh->valid) pages = NULL;
+
+    hash_memory(mh, gb->bus.vram, VRAM_SIZE, 0x8000, pages);
+    hash_memory(mh, gb->bus.wram, WRAM_SIZE, 0xC000, pages);
+    hash_memory(mh, gb->bus.oam, OAM_SIZE, 0xFE00, pages);
+    hash_memory(mh, gb->bus.hram, HRAM_SIZE, 0xFF80, pages);
+
+    // La RAM externa, entera en la entrada de $A000 (como en los estados)
+    bool cart_dirty = !pages;
+    for (u32 a = 0xA000; a < 0xC000 && !cart_dirty; a += BUS_PAGE_SIZE) {
+        cart_dirty = bus_page_dirty(pages, a);
+    }
+    if (cart_dirty) {
+        u64 h = HASH_SEED;
+        for (int n = 0; n < gb->cart.ram_banks; n++) {
+            h = hash_bytes(cart_ram_bank(&gb->cart, n), RAM_BANK_SIZE, h);
+        }
+        mh->page[0xA0] = h;
+    }
+    mh->valid = true;
+
+    // Las páginas sin usar valen 0 y no cambian el resultado
+    u64 h = HASH_SEED;
+    for (int i = 0; i < BUS_PAGES; i++) {
+        if (mh->page[i]) h = hash_combine(h, mh->page[i]);
+    }
+    return h;
+}
@@ -6,7 +6,7 @@
 void set_state(GameBoy* gb, cJSON* state)
 {
     // 0. Activamos el modo test
-    gb->bus.test_mode = true;
+    gb->bus.access_mode = BUS_MODE_TEST;
 
     // 1. Cargar Registros
     gb->cpu.pc = cJSON_GetObjectItem(state, "pc")->valueint;
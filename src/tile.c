@@ -0,0 +1,283 @@
+// src/tile.c
+#include <string.h>
+#include "tile.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TILE_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+// ------------------------------ Escalar --------------------------------
+
+static void decode_rows_scalar(const u8* planar, u8* out, int rows) {
+    for (int row = 0; row < rows; row++) {
+        u8 lo = planar[row * 2];
+        u8 hi = planar[row * 2 + 1];
+        for (int x = 0; x < 8; x++) {
+            out[row * 8 + x] = (BIT(hi, 7 - x) << 1) | BIT(lo, 7 - x);
+        }
+    }
+}
+
+static void map_pack_scalar(const u8* in, u8* out, const u8* lut, int count) {
+    for (int i = 0; i < count; i += 4) {
+        out[i / 4] = lut[in[i]] | (lut[in[i + 1]] << 2) | (lut[in[i + 2]] << 4) | (lut[in[i + 3]] << 6);
+    }
+}
+
+static void unpack_scalar(const u8* packed, u8* out, const u8* lut, int count) {
+    for (int i = 0; i < count; i++) {
+        out[i] = lut[(packed[i / 4] >> ((i & 3) * 2)) & 3];
+    }
+}
+
+static void unpack_rgba_scalar(const u8* packed, u8* out, const u8 lut[4][4], int count) {
+    for (int i = 0; i < count; i++) {
+        memcpy(&out[i * 4], lut[(packed[i / 4] >> ((i & 3) * 2)) & 3], 4);
+    }
+}
+
+#ifdef TILE_HAVE_X86
+
+// -------------------------------- SSE2 ---------------------------------
+// Cada fila se expande a [lo x8 | hi x8] con desempaquetados, se comprueba
+// cada bit contra la máscara (el bit 7 es el píxel de la izquierda) y se
+// suman las dos mitades (lo*1 + hi*2).
+
+__attribute__((target("sse2")))
+static inline __m128i decode_row_sse2(__m128i lo_hi, __m128i mask, __m128i weight) {
+    __m128i bits = _mm_cmpeq_epi8(_mm_and_si128(lo_hi, mask), mask);
+    bits = _mm_and_si128(bits, weight);
+    return _mm_add_epi8(bits, _mm_srli_si128(bits, 8));
+}
+
+__attribute__((target("sse2")))
+static void decode_rows_sse2(const u8* planar, u8* out, int rows) {
+    const __m128i mask = _mm_setr_epi8((char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                       (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i weight = _mm_setr_epi8(1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2);
+
+    int row = 0;
+    for (; row + 2 <= rows; row += 2) {
+        // [lo0 hi0 lo1 hi1] -> [lo0 x4 hi0 x4 lo1 x4 hi1 x4]
+        int raw;
+        memcpy(&raw, &planar[row * 2], sizeof(raw));
+        __m128i v = _mm_cvtsi32_si128(raw);
+        v = _mm_unpacklo_epi8(v, v);
+        v = _mm_unpacklo_epi16(v, v);
+
+        __m128i row0 = decode_row_sse2(_mm_unpacklo_epi32(v, v), mask, weight);
+        __m128i row1 = decode_row_sse2(_mm_unpackhi_epi32(v, v), mask, weight);
+        _mm_storeu_si128((__m128i*)&out[row * 8], _mm_unpacklo_epi64(row0, row1));
+    }
+
+    decode_rows_scalar(&planar[row * 2], &out[row * 8], rows - row);
+}
+
+// ------------------------------- SSSE3 ---------------------------------
+// La paleta es una tabla de 16 entradas: cabe entera en un PSHUFB. Para
+// empaquetar, PMADDUBSW junta parejas (a + 4b) y PMADDWD parejas de parejas
+// (x + 16y): 16 tonos acaban en 4 bytes.
+
+__attribute__((target("ssse3")))
+static void map_pack_ssse3(const u8* in, u8* out, const u8* lut, int count) {
+    const __m128i table = _mm_loadu_si128((const __m128i*)lut);
+    const __m128i pairs = _mm_set1_epi16(0x0401);
+    const __m128i quads = _mm_set1_epi32(0x00100001);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_shuffle_epi8(table, _mm_loadu_si128((const __m128i*)&in[i]));
+        v = _mm_madd_epi16(_mm_maddubs_epi16(v, pairs), quads);
+        v = _mm_packus_epi16(_mm_packs_epi32(v, v), v);
+
+        int packed = _mm_cvtsi128_si32(v);
+        memcpy(&out[i / 4], &packed, sizeof(packed));
+    }
+
+    map_pack_scalar(&in[i], &out[i / 4], lut, count - i);
+}
+
+// Desempaquetado: cada byte se repite 4 veces y cada copia se queda con su
+// par de bits, sin desplazar los de las posiciones 0-1 (valores 0-3 y 0, 4,
+// 8, 12) y bajando 4 bits los de las 2-3. Esos 7 valores posibles indexan
+// una tabla de 16 entradas con un PSHUFB.
+
+__attribute__((target("ssse3")))
+static inline __m128i unpack_index_ssse3(const u8* packed) {
+    const __m128i spread = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+    const __m128i low = _mm_set1_epi32(0x00000C03);
+    const __m128i high = _mm_set1_epi32(0x0C030000);
+
+    int raw;
+    memcpy(&raw, packed, sizeof(raw));
+    __m128i v = _mm_shuffle_epi8(_mm_cvtsi32_si128(raw), spread);
+    return _mm_or_si128(_mm_and_si128(v, low), _mm_and_si128(_mm_srli_epi16(v, 4), high));
+}
+
+// Tabla de 16 entradas para los índices de unpack_index_ssse3
+static void unpack_table(const u8* lut, int stride, u8* table) {
+    memset(table, 0, 16);
+    for (int shade = 0; shade < 4; shade++) {
+        table[shade] = lut[shade * stride];
+        table[shade << 2] = lut[shade * stride];
+    }
+}
+
+__attribute__((target("ssse3")))
+static void unpack_ssse3(const u8* packed, u8* out, const u8* lut, int count) {
+    u8 bytes[16];
+    unpack_table(lut, 1, bytes);
+    const __m128i table = _mm_loadu_si128((const __m128i*)bytes);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_shuffle_epi8(table, unpack_index_ssse3(&packed[i / 4]));
+        _mm_storeu_si128((__m128i*)&out[i], v);
+    }
+
+    unpack_scalar(&packed[i / 4], &out[i], lut, count - i);
+}
+
+__attribute__((target("ssse3")))
+static void unpack_rgba_ssse3(const u8* packed, u8* out, const u8 lut[4][4], int count) {
+    // Una tabla por canal; después se entrelazan R, G, B y A
+    __m128i channel[4];
+    for (int c = 0; c < 4; c++) {
+        u8 bytes[16];
+        unpack_table(&lut[0][c], 4, bytes);
+        channel[c] = _mm_loadu_si128((const __m128i*)bytes);
+    }
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i index = unpack_index_ssse3(&packed[i / 4]);
+        __m128i r = _mm_shuffle_epi8(channel[0], index);
+        __m128i g = _mm_shuffle_epi8(channel[1], index);
+        __m128i b = _mm_shuffle_epi8(channel[2], index);
+        __m128i a = _mm_shuffle_epi8(channel[3], index);
+
+        __m128i rg_lo = _mm_unpacklo_epi8(r, g);
+        __m128i rg_hi = _mm_unpackhi_epi8(r, g);
+        __m128i ba_lo = _mm_unpacklo_epi8(b, a);
+        __m128i ba_hi = _mm_unpackhi_epi8(b, a);
+
+        __m128i* dst = (__m128i*)&out[i * 4];
+        _mm_storeu_si128(dst + 0, _mm_unpacklo_epi16(rg_lo, ba_lo));
+        _mm_storeu_si128(dst + 1, _mm_unpackhi_epi16(rg_lo, ba_lo));
+        _mm_storeu_si128(dst + 2, _mm_unpacklo_epi16(rg_hi, ba_hi));
+        _mm_storeu_si128(dst + 3, _mm_unpackhi_epi16(rg_hi, ba_hi));
+    }
+
+    unpack_rgba_scalar(&packed[i / 4], &out[i * 4], lut, count - i);
+}
+
+// -------------------------------- AVX2 ---------------------------------
+// Cuatro filas por iteración: VPSHUFB reparte cada byte de plano en 8 lanes.
+// El resto de kernels trabaja con líneas de 160 píxeles y se queda en SSSE3.
+
+__attribute__((target("avx2")))
+static void decode_rows_avx2(const u8* planar, u8* out, int rows) {
+    const __m256i mask = _mm256_setr_epi8(
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+        (char)0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    // Los 8 bytes de entrada se repiten en las dos mitades de 128 bits
+    const __m256i pick_lo = _mm256_setr_epi8(
+        0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2,
+        4, 4, 4, 4, 4, 4, 4, 4, 6, 6, 6, 6, 6, 6, 6, 6);
+    const __m256i pick_hi = _mm256_setr_epi8(
+        1, 1, 1, 1, 1, 1, 1, 1, 3, 3, 3, 3, 3, 3, 3, 3,
+        5, 5, 5, 5, 5, 5, 5, 5, 7, 7, 7, 7, 7, 7, 7, 7);
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi8(2);
+
+    int row = 0;
+    for (; row + 4 <= rows; row += 4) {
+        __m256i v = _mm256_broadcastsi128_si256(_mm_loadl_epi64((const __m128i*)&planar[row * 2]));
+
+        __m256i lo = _mm256_shuffle_epi8(v, pick_lo);
+        __m256i hi = _mm256_shuffle_epi8(v, pick_hi);
+        lo = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(lo, mask), mask), one);
+        hi = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(hi, mask), mask), two);
+
+        _mm256_storeu_si256((__m256i*)&out[row * 8], _mm256_or_si256(lo, hi));
+    }
+
+    decode_rows_sse2(&planar[row * 2], &out[row * 8], rows - row);
+}
+
+#endif // TILE_HAVE_X86
+
+// --------------------------- Selección ---------------------------------
+
+void (*tile_decode_rows)(const u8* planar, u8* out, int rows) = decode_rows_scalar;
+void (*tile_map_pack)(const u8* in, u8* out, const u8* lut, int count) = map_pack_scalar;
+void (*tile_unpack)(const u8* packed, u8* out, const u8* lut, int count) = unpack_scalar;
+void (*tile_unpack_rgba)(const u8* packed, u8* out, const u8 lut[4][4], int count) = unpack_rgba_scalar;
+
+static bool backend_supported(TileBackend backend) {
+    switch (backend) {
+        case TILE_BACKEND_SCALAR:
+            return true;
+#ifdef TILE_HAVE_X86
+        case TILE_BACKEND_SSE:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2") && __builtin_cpu_supports("ssse3");
+        case TILE_BACKEND_AVX2:
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#endif
+        default:
+            return false;
+    }
+}
+
+bool tile_set_backend(TileBackend backend) {
+    if (!backend_supported(backend)) return false;
+
+    switch (backend) {
+#ifdef TILE_HAVE_X86
+        case TILE_BACKEND_SSE:
+        case TILE_BACKEND_AVX2:
+            tile_decode_rows = backend == TILE_BACKEND_AVX2 ? decode_rows_avx2 : decode_rows_sse2;
+            tile_map_pack = map_pack_ssse3;
+            tile_unpack = unpack_ssse3;
+            tile_unpack_rgba = unpack_rgba_ssse3;
+            break;
+#endif
+        default:
+            tile_decode_rows = decode_rows_scalar;
+            tile_map_pack = map_pack_scalar;
+            tile_unpack = unpack_scalar;
+            tile_unpack_rgba = unpack_rgba_scalar;
+            break;
+    }
+    return true;
+}
+
+// Elegido por tile_init (-1 = todavía no; atómico)
+static int best_backend = -1;
+
+TileBackend tile_init(void) {
+    int best = __atomic_load_n(&best_backend, __ATOMIC_ACQUIRE);
+    if (best >= 0) return (TileBackend)best;
+
+    if (tile_set_backend(TILE_BACKEND_AVX2)) best = TILE_BACKEND_AVX2;
+    else if (tile_set_backend(TILE_BACKEND_SSE)) best = TILE_BACKEND_SSE;
+    else {
+        tile_set_backend(TILE_BACKEND_SCALAR);
+        best = TILE_BACKEND_SCALAR;
+    }
+    __atomic_store_n(&best_backend, best, __ATOMIC_RELEASE);
+    return (TileBackend)best;
+}
+
+const char* tile_backend_name(TileBackend backend) {
+    switch (backend) {
+        case TILE_BACKEND_SSE:  return "sse";
+        case TILE_BACKEND_AVX2: return "avx2";
+        default:                return "scalar";
+    }
+}
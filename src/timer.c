@@ -0,0 +1,144 @@
+// src/timer.c
+#include "gb.h"
+
+// Periodo (ticks) de TIMA para cada frecuencia de TAC: 4096, 262144, 65536
+// y 16384 Hz. Cada periodo es el flanco de bajada del bit (periodo / 2) del
+// contador interno.
+static const u16 tima_periods[4] = { 1024, 16, 64, 256 };
+
+// El desbordamiento real recarga TMA 4 ticks después (TIMA vale 0 entre
+// medias); aquí la recarga es inmediata.
+
+static bool timer_enabled(const Timer* timer) {
+    return BIT(timer->tac, TAC_ENABLE);
+}
+
+static u64 timer_counter(GameBoy* gb) {
+    return gb->ticks - gb->timer.div_base;
+}
+
+// Lleva TIMA hasta gb->ticks. Devuelve los desbordamientos que ha habido.
+static int timer_sync(GameBoy* gb) {
+    Timer* timer = &gb->timer;
+    int overflows = 0;
+
+    if (timer_enabled(timer)) {
+        u64 period = tima_periods[timer->tac & 3];
+        u64 edges = (gb->ticks - timer->div_base) / period
+                  - (timer->tima_time - timer->div_base) / period;
+
+        while (edges >= 256u - timer->tima) {
+            edges -= 256u - timer->tima;
+            timer->tima = timer->tma;
+            overflows++;
+        }
+        timer->tima += edges;
+    }
+
+    timer->tima_time = gb->ticks;
+    return overflows;
+}
+
+// Programa el siguiente desbordamiento a partir del estado actual
+static void timer_schedule(GameBoy* gb) {
+    Timer* timer = &gb->timer;
+    if (!timer_enabled(timer)) {
+        sched_cancel(gb, EVENT_TIMER);
+        return;
+    }
+
+    u64 period = tima_periods[timer->tac & 3];
+    u64 edge = (timer->tima_time - timer->div_base) / period + (256u - timer->tima);
+    sched_schedule(gb, EVENT_TIMER, timer->div_base + edge * period);
+}
+
+// Sincroniza, pide la interrupción si hace falta y reprograma
+static void timer_update(GameBoy* gb) {
+    if (timer_sync(gb)) {
+        cpu_request_interrupt(gb, INT_TIMER);
+    }
+    timer_schedule(gb);
+}
+
+// Un flanco de bajada "artificial" (el bit elegido pasa de 1 a 0 por una
+// escritura en DIV o TAC) también incrementa TIMA
+static void timer_glitch_edge(GameBoy* gb) {
+    Timer* timer = &gb->timer;
+    if (++timer->tima == 0) {
+        timer->tima = timer->tma;
+        cpu_request_interrupt(gb, INT_TIMER);
+    }
+}
+
+static bool timer_bit_set(GameBoy* gb, u8 tac) {
+    return BIT(tac, TAC_ENABLE) && (timer_counter(gb) & (tima_periods[tac & 3] / 2));
+}
+
+void timer_init(GameBoy* gb) {
+    Timer* timer = &gb->timer;
+    // DIV = $AB tras la boot ROM de la DMG
+    timer->div_base = gb->ticks - 0xABCC;
+    timer->tima_time = gb->ticks;
+    timer->tima = 0;
+    timer->tma = 0;
+    timer->tac = 0xF8;
+    sched_cancel(gb, EVENT_TIMER);
+}
+
+u8 timer_read(GameBoy* gb, u16 address) {
+    switch (address) {
+        case REG_DIV_ADDR:
+            return (timer_counter(gb) >> 8) & 0xFF;
+        case REG_TIMA_ADDR:
+            timer_update(gb);
+            return gb->timer.tima;
+        case REG_TMA_ADDR:
+            return gb->timer.tma;
+        default: // TAC: bits 3-7 a 1
+            return gb->timer.tac | 0xF8;
+    }
+}
+
+void timer_reset_div(GameBoy* gb) {
+    timer_update(gb);
+    if (timer_bit_set(gb, gb->timer.tac)) timer_glitch_edge(gb);
+
+    // tima_time pasa a ser el inicio del nuevo contador (sin flancos previos)
+    gb->timer.div_base = gb->ticks;
+    gb->timer.tima_time = gb->ticks;
+    timer_schedule(gb);
+
+    // El frame sequencer de la APU cuelga del mismo divisor
+    apu_reset_div(gb);
+}
+
+void timer_write(GameBoy* gb, u16 address, u8 value) {
+    Timer* timer = &gb->timer;
+
+    switch (address) {
+        case REG_DIV_ADDR: // Cualquier escritura lo pone a 0
+            timer_reset_div(gb);
+            break;
+        case REG_TIMA_ADDR:
+            timer_update(gb);
+            timer->tima = value;
+            timer_schedule(gb);
+            break;
+        case REG_TMA_ADDR:
+            timer_update(gb);
+            timer->tma = value;
+            break;
+        default: // TAC
+            timer_update(gb);
+            if (timer_bit_set(gb, timer->tac) && !timer_bit_set(gb, value)) {
+                timer_glitch_edge(gb);
+            }
+            timer->tac = value | 0xF8;
+            timer_schedule(gb);
+            break;
+    }
+}
+
+void timer_event(GameBoy* gb) {
+    timer_update(gb);
+}
@@ -0,0 +1,219 @@
+// src/video_out.c
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "video_out.h"
+#include "framebuffer.h"
+
+struct VideoOut {
+    FILE* out;
+    VideoFormat format;
+    int scale;        // ScaleFilter, o -1
+    u32 rate_num;
+    u32 rate_den;
+
+    // Anillo de frames (empaquetados): la emulación llena head, el hilo
+    // vacía tail. Los índices solo crecen; el hueco es índice % VIDEO_RING_SIZE.
+    Frame ring[VIDEO_RING_SIZE];
+    u64 head;
+    u64 tail;
+    bool closing;
+    bool failed;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+
+    // Buffers de conversión (solo los usa el hilo). Con escalado, el frame
+    // pasa a RGBA en rgba y se escala en scaled.
+    u8 converted[FB_PIXELS * 4];
+    u32* rgba;
+    u32* scaled;
+};
+
+bool video_format_parse(const char* name, VideoFormat* format) {
+    if (strcmp(name, "y4m") == 0) *format = VIDEO_FORMAT_Y4M;
+    else if (strcmp(name, "rgb") == 0) *format = VIDEO_FORMAT_RGB;
+    else if (strcmp(name, "indexed") == 0) *format = VIDEO_FORMAT_INDEXED;
+    else return false;
+    return true;
+}
+
+// ------------------------- Hilo de escritura ---------------------------
+
+// Escala el frame y lo convierte en el mismo buffer (el destino nunca
+// adelanta al origen)
+static bool write_scaled(VideoOut* video, const Frame* frame) {
+    int factor = scale_factor(video->scale);
+    size_t pixels = (size_t)FB_PIXELS * factor * factor;
+    scale_frame(video->scale, frame, video->rgba, video->scaled);
+    u8* data = (u8*)video->scaled;
+    size_t size;
+
+    if (video->format == VIDEO_FORMAT_Y4M) {
+        if (fputs("FRAME\n", video->out) == EOF) return false;
+        // Luminancia BT.601, como fb_to_gray
+        for (size_t i = 0; i < pixels; i++) {
+            const u8* c = &data[i * 4];
+            data[i] = (c[0] * 77 + c[1] * 150 + c[2] * 29) >> 8;
+        }
+        size = pixels;
+    }
+    else {
+        for (size_t i = 0; i < pixels; i++) memmove(&data[i * 3], &data[i * 4], 3);
+        size = pixels * 3;
+    }
+    return fwrite(data, 1, size, video->out) == size;
+}
+
+static bool write_frame(VideoOut* video, const Frame* frame) {
+    if (video->scale >= 0) return write_scaled(video, frame);
+
+    u8* data = video->converted;
+    size_t size = FB_PIXELS;
+
+    switch (video->format) {
+        case VIDEO_FORMAT_Y4M:
+            if (fputs("FRAME\n", video->out) == EOF) return false;
+            fb_to_gray(frame, data);
+            break;
+        case VIDEO_FORMAT_RGB:
+            // RGBA -> RGB24 sobre el mismo buffer (el destino nunca adelanta)
+            fb_to_rgba(frame, data);
+            for (int i = 0; i < FB_PIXELS; i++) {
+                memmove(&data[i * 3], &data[i * 4], 3);
+            }
+            size = FB_PIXELS * 3;
+            break;
+        case VIDEO_FORMAT_INDEXED:
+            fb_unpack(frame, data);
+            break;
+    }
+
+    return fwrite(data, 1, size, video->out) == size;
+}
+
+static void* writer_thread(void* arg) {
+    VideoOut* video = arg;
+    bool ok = true;
+
+    if (video->format == VIDEO_FORMAT_Y4M) {
+        int factor = video->scale >= 0 ? scale_factor(video->scale) : 1;
+        ok = fprintf(video->out, "YUV4MPEG2 W%d H%d F%u:%u Ip A1:1 Cmono\n",
+                     LCD_WIDTH * factor, LCD_HEIGHT * factor, video->rate_num, video->rate_den) > 0;
+    }
+
+    pthread_mutex_lock(&video->lock);
+    while (ok) {
+        while (video->head == video->tail && !video->closing) {
+            pthread_cond_wait(&video->not_empty, &video->lock);
+        }
+        if (video->head == video->tail) break; // Cerrando y sin pendientes
+
+        // El hueco de tail es nuestro hasta que avancemos tail
+        const Frame* frame = &video->ring[video->tail % VIDEO_RING_SIZE];
+        pthread_mutex_unlock(&video->lock);
+        ok = write_frame(video, frame);
+        pthread_mutex_lock(&video->lock);
+
+        video->tail++;
+        pthread_cond_signal(&video->not_full);
+    }
+
+    if (ok && fflush(video->out) != 0) ok = false;
+    if (!ok) {
+        // Despierta a la emulación para que vea el error
+        video->failed = true;
+        pthread_cond_signal(&video->not_full);
+    }
+    pthread_mutex_unlock(&video->lock);
+    return NULL;
+}
+
+// ------------------------------ Interfaz -------------------------------
+
+static void video_free(VideoOut* video) {
+    free(video->rgba);
+    free(video->scaled);
+    free(video);
+}
+
+VideoOut* video_out_open(const char* path, VideoFormat format, int scale, u32 rate_num, u32 rate_den) {
+    if (scale >= SCALE_FILTER_COUNT || (scale >= 0 && format == VIDEO_FORMAT_INDEXED)) return NULL;
+
+    VideoOut* video = calloc(1, sizeof(*video));
+    if (!video) return NULL;
+
+    video->scale = scale;
+    if (scale >= 0) {
+        // Kernels SIMD del escalado según la CPU
+        scale_init();
+        int factor = scale_factor(scale);
+        video->rgba = malloc(sizeof(u32) * FB_PIXELS);
+        video->scaled = malloc(sizeof(u32) * FB_PIXELS * factor * factor);
+        if (!video->rgba || !video->scaled) {
+            video_free(video);
+            return NULL;
+        }
+    }
+
+    video->out = strcmp(path, "-") == 0 ? stdout : fopen(path, "wb");
+    if (!video->out) {
+        video_free(video);
+        return NULL;
+    }
+    // Varios frames por write()
+    setvbuf(video->out, NULL, _IOFBF, 1 << 18);
+
+    video->format = format;
+    video->rate_num = rate_num;
+    video->rate_den = rate_den;
+
+    pthread_mutex_init(&video->lock, NULL);
+    pthread_cond_init(&video->not_empty, NULL);
+    pthread_cond_init(&video->not_full, NULL);
+    if (pthread_create(&video->thread, NULL, writer_thread, video) != 0) {
+        if (video->out != stdout) fclose(video->out);
+        video_free(video);
+        return NULL;
+    }
+    return video;
+}
+
+bool video_out_push(VideoOut* video, const Frame* frame) {
+    pthread_mutex_lock(&video->lock);
+    while (video->head - video->tail == VIDEO_RING_SIZE && !video->failed) {
+        pthread_cond_wait(&video->not_full, &video->lock);
+    }
+    bool failed = video->failed;
+    pthread_mutex_unlock(&video->lock);
+    if (failed) return false;
+
+    // El hueco de head es nuestro hasta que avancemos head
+    video->ring[video->head % VIDEO_RING_SIZE] = *frame;
+
+    pthread_mutex_lock(&video->lock);
+    video->head++;
+    pthread_cond_signal(&video->not_empty);
+    pthread_mutex_unlock(&video->lock);
+    return true;
+}
+
+bool video_out_close(VideoOut* video) {
+    pthread_mutex_lock(&video->lock);
+    video->closing = true;
+    pthread_cond_signal(&video->not_empty);
+    pthread_mutex_unlock(&video->lock);
+    pthread_join(video->thread, NULL);
+
+    bool ok = !video->failed;
+    if (video->out != stdout && fclose(video->out) != 0) ok = false;
+
+    pthread_mutex_destroy(&video->lock);
+    pthread_cond_destroy(&video->not_empty);
+    pthread_cond_destroy(&video->not_full);
+    video_free(video);
+    return ok;
+}